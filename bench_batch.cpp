@@ -0,0 +1,164 @@
+// ///////////////////////////// MIT License //////////////////////////////////// //
+//                                                                                //
+// Copyright (c) 2013 David Zsolt Manrique                                        //
+//                    david.zsolt.manrique@gmail.com                              //
+//                                                                                //
+// Permission is hereby granted, free of charge, to any person obtaining a copy   //
+// of this software and associated documentation files (the "Software"), to deal  //
+// in the Software without restriction, including without limitation the rights   //
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      //
+// copies of the Software, and to permit persons to whom the Software is          //
+// furnished to do so, subject to the following conditions:                       //
+//                                                                                //
+// The above copyright notice and this permission notice shall be included in     //
+// all copies or substantial portions of the Software.                            //
+//                                                                                //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    //
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  //
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN      //
+// THE SOFTWARE.                                                                  //
+//                                                                                //
+// ////////////////////////////////////////////////////////////////////////////// //
+
+
+
+// batch validation benchmark on a generated job manifest
+// one command line per line against one option set, about 1 in 10 lines invalid. the serial
+// baseline builds a fresh arguments object and every argument per line and catches the errors,
+// cmdl::batch maps the manifest and validates it on 1, 2, 4, ... threads.
+//
+//   bench_batch                          10^6 lines
+//   bench_batch -n 100000 -j 8 -f jobs.txt
+
+#include "cmdl_batch.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+using namespace cmdl;
+
+//! a manifest line of a job submission tool
+
+std::string job_line(std::mt19937 & rng, std::size_t i) {
+    std::string line = "submit --queue q" + std::to_string(rng() % 8) + " -j " + std::to_string(1 + rng() % 64);
+    line += " --memory " + std::to_string(256 << (rng() % 6)) + " --name job" + std::to_string(i);
+    for (unsigned k = rng() % 4; k > 0; k--) line += " -e VAR" + std::to_string(k) + "=" + std::to_string(rng() % 1000);
+    if (rng() % 2) line += " --retry";
+    line += " --range " + std::to_string(rng() % 100) + " " + std::to_string(100 + rng() % 100);
+    switch (rng() % 20) {
+        case 0: line += " -j many";
+            break; // not a number
+        case 1: line += " --memory";
+            break; // missing value
+        default: break;
+    }
+    line += " input" + std::to_string(i) + ".dat output" + std::to_string(i) + ".dat";
+    return line;
+}
+
+//! the option set, declared on a parser or on an arguments object
+
+struct job_options {
+    switcharg<false> retry;
+    vararg<std::string> queue;
+    vararg<int> jobs;
+    vararg<long> memory;
+    vararg<std::string> name;
+    multivararg<std::string> environment;
+    tuplevararg<int, int> range;
+    multiposarg<std::string> files;
+
+    explicit job_options(arguments & args) :
+    retry(args, "-r", "--retry", "retry failed jobs"),
+    queue(args, "-q", "--queue", "queue name", "default"),
+    jobs(args, "-j", "--jobs", "number of jobs", 1),
+    memory(args, "-m", "--memory", "memory in MB", 1024),
+    name(args, "-n", "--name", "job name", ""),
+    environment(args, "-e", "--env", "environment variable", ""),
+    range(args, "-R", "--range", "first and last task", 0, 0),
+    files(args, "input and output files", "", 2) {
+    }
+};
+
+int main(int argc, char** argv) {
+    arguments args(argc, argv);
+    switcharg<false> help(args, "-h", "--help", "print help message");
+    vararg<std::size_t> lines(args, "-n", "--lines", "number of manifest lines", 1000000);
+    vararg<unsigned> max_threads(args, "-j", "--threads", "largest thread count, 0 for the hardware concurrency", 0);
+    vararg<std::string> path(args, "-f", "--file", "manifest file to generate", "bench_batch_manifest.txt");
+
+    if (*help) {
+        args.print_help(std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    std::mt19937 rng(1);
+    {
+        std::ofstream os(*path, std::ios::binary);
+        for (std::size_t i = 0; i < *lines; i++) os << job_line(rng, i) << '\n';
+        if (!os) {
+            std::cerr << "cannot write " << *path << std::endl;
+            return EXIT_FAILURE;
+        }
+    }
+
+    parser p;
+    p.add<switcharg<false> >("-r", "--retry", "retry failed jobs");
+    p.add<vararg<std::string> >("-q", "--queue", "queue name", "default");
+    auto jobs = p.add<vararg<int> >("-j", "--jobs", "number of jobs", 1);
+    p.add<vararg<long> >("-m", "--memory", "memory in MB", 1024);
+    p.add<vararg<std::string> >("-n", "--name", "job name", "");
+    p.add<multivararg<std::string> >("-e", "--env", "environment variable", "");
+    p.add<tuplevararg<int, int> >("-R", "--range", "first and last task", 0, 0);
+    p.add<multiposarg<std::string> >("input and output files", "", 2);
+
+    auto per_minute = [](std::size_t count, double seconds) {
+        return double(count) / seconds * 60.0 / 1e6;
+    };
+
+    std::cout << std::left << std::setw(24) << "method" << std::right << std::setw(12) << "seconds"
+            << std::setw(16) << "M lines/min" << std::setw(10) << "errors" << std::endl;
+
+    // serial baseline on at most 10^5 lines
+    {
+        std::ifstream is(*path);
+        std::string line;
+        std::size_t count = 0, errors = 0;
+        auto start = std::chrono::steady_clock::now();
+        while (count < 100000 && std::getline(is, line)) {
+            count++;
+            try {
+                arguments job(line);
+                job_options options(job);
+            } catch (const std::runtime_error &) {
+                errors++;
+            }
+        }
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+        std::cout << std::left << std::setw(24) << "serial, declare per line" << std::right << std::setw(12) << seconds.count()
+                << std::setw(16) << per_minute(count, seconds.count()) << std::setw(10) << errors << std::endl;
+    }
+
+    unsigned threads = *max_threads ? *max_threads : std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned t = 1;; t = std::min(t * 2, threads)) {
+        auto start = std::chrono::steady_clock::now();
+        batch::report report = batch(p).validate_file(*path, t);
+        std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+        long long checksum = 0;
+        for (std::size_t row = 0; row < report.size(); row++)
+            if (report.ok(row)) checksum += report.value(jobs, row);
+
+        std::cout << std::left << std::setw(24) << ("batch, " + std::to_string(t) + " threads") << std::right << std::setw(12) << seconds.count()
+                << std::setw(16) << per_minute(report.size(), seconds.count()) << std::setw(10) << report.errors()
+                << "   jobs " << checksum << std::endl;
+        if (t == threads) break;
+    }
+
+    std::remove(path.val().c_str());
+}
@@ -0,0 +1,332 @@
+// ///////////////////////////// MIT License //////////////////////////////////// //
+//                                                                                //
+// Copyright (c) 2013 David Zsolt Manrique                                        //
+//                    david.zsolt.manrique@gmail.com                              //
+//                                                                                //
+// Permission is hereby granted, free of charge, to any person obtaining a copy   //
+// of this software and associated documentation files (the "Software"), to deal  //
+// in the Software without restriction, including without limitation the rights   //
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      //
+// copies of the Software, and to permit persons to whom the Software is          //
+// furnished to do so, subject to the following conditions:                       //
+//                                                                                //
+// The above copyright notice and this permission notice shall be included in     //
+// all copies or substantial portions of the Software.                            //
+//                                                                                //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    //
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  //
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN      //
+// THE SOFTWARE.                                                                  //
+//                                                                                //
+// ////////////////////////////////////////////////////////////////////////////// //
+
+
+// parse benchmark on synthetic command lines
+// every scenario declares a number of options of one kind and value type, and parses a
+// generated command line of a given number of tokens. tokens that no option takes are
+// leftover values, so the token count and the option count vary independently.
+//
+//   bench_cmdl                       full grid, 10 - 10^6 tokens, 1 - 1000 options
+//   bench_cmdl -k multivararg -t int -n 100000
+
+#include "cmdl.h"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#else
+#include <malloc.h>
+#endif
+
+using namespace cmdl;
+
+// heap accounting: the blocks are counted with the size the allocator reports for them, so
+// no header is needed and every new and delete overload goes straight to the C allocator
+
+namespace {
+    std::size_t allocations = 0;
+    std::size_t heap_current = 0;
+    std::size_t heap_peak = 0;
+
+    std::size_t block_size(void* p, std::size_t alignment) {
+#if defined(_WIN32)
+        return alignment > alignof(std::max_align_t) ? _aligned_msize(p, alignment, 0) : _msize(p);
+#elif defined(__APPLE__)
+        (void) alignment;
+        return malloc_size(p);
+#else
+        (void) alignment;
+        return malloc_usable_size(p);
+#endif
+    }
+
+    void* allocate(std::size_t size, std::size_t alignment) {
+        if (size == 0) size = 1;
+#if defined(_WIN32)
+        void* p = alignment > alignof(std::max_align_t) ? _aligned_malloc(size, alignment) : std::malloc(size);
+#else
+        void* p = nullptr;
+        if (alignment <= alignof(std::max_align_t)) p = std::malloc(size);
+        else if (posix_memalign(&p, alignment, size) != 0) p = nullptr;
+#endif
+        if (!p) throw std::bad_alloc();
+        allocations++;
+        heap_current += block_size(p, alignment);
+        if (heap_current > heap_peak) heap_peak = heap_current;
+        return p;
+    }
+
+    void deallocate(void* p, std::size_t alignment) noexcept {
+        if (!p) return;
+        heap_current -= block_size(p, alignment);
+#if defined(_WIN32)
+        if (alignment > alignof(std::max_align_t)) _aligned_free(p);
+        else std::free(p);
+#else
+        std::free(p);
+#endif
+    }
+}
+
+void* operator new(std::size_t size) {
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](std::size_t size) {
+    return allocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return allocate(size, std::size_t(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return allocate(size, std::size_t(alignment));
+}
+
+void operator delete(void* p) noexcept {
+    deallocate(p, alignof(std::max_align_t));
+}
+
+void operator delete[](void* p) noexcept {
+    deallocate(p, alignof(std::max_align_t));
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    deallocate(p, alignof(std::max_align_t));
+}
+
+void operator delete[](void* p, std::size_t) noexcept {
+    deallocate(p, alignof(std::max_align_t));
+}
+
+void operator delete(void* p, std::align_val_t alignment) noexcept {
+    deallocate(p, std::size_t(alignment));
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept {
+    deallocate(p, std::size_t(alignment));
+}
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept {
+    deallocate(p, std::size_t(alignment));
+}
+
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept {
+    deallocate(p, std::size_t(alignment));
+}
+
+//! storage for the argument objects of one scenario, allocated once outside the measurement
+
+template<typename Arg>
+class slots {
+    std::unique_ptr<typename std::aligned_storage<sizeof (Arg), alignof (Arg)>::type[] > _slots;
+    std::size_t _n;
+public:
+
+    explicit slots(std::size_t capacity) : _slots(new typename std::aligned_storage<sizeof (Arg), alignof (Arg)>::type[capacity]), _n(0) {
+    }
+
+    ~slots() {
+        clear();
+    }
+
+    template<typename... Args>
+    void emplace(Args &&... args) {
+        new (&_slots[_n]) Arg(std::forward<Args>(args)...);
+        _n++;
+    }
+
+    void clear() {
+        while (_n) reinterpret_cast<Arg*> (&_slots[--_n])->~Arg();
+    }
+};
+
+template<typename Type> const char* type_label();
+template<> const char* type_label<int>() { return "int"; }
+template<> const char* type_label<double>() { return "double"; }
+template<> const char* type_label<std::string>() { return "string"; }
+
+template<typename Type> std::string value(std::size_t i);
+template<> std::string value<int>(std::size_t i) { return std::to_string(i % 100000); }
+template<> std::string value<double>(std::size_t i) { return std::to_string(double(i % 100000) * 0.25); }
+template<> std::string value<std::string>(std::size_t i) { return "s" + std::to_string(i); }
+
+//! one benchmark scenario: the command line and the option names
+
+struct scenario {
+    std::string kind;
+    std::size_t options;
+    std::vector<std::string> short_names, long_names;
+    std::vector<std::string> store;
+    std::vector<char*> argv;
+
+    scenario(const std::string & k, std::size_t n) : kind(k), options(n) {
+        for (std::size_t i = 0; i < n; i++) {
+            short_names.push_back("-a" + std::to_string(i));
+            long_names.push_back("--option-" + std::to_string(i));
+        }
+    }
+
+    //! number of tokens of one occurrence, 0 for positional kinds
+
+    std::size_t width() const {
+        if (kind == "switcharg") return 1;
+        if (kind == "vararg" || kind == "multivararg") return 2;
+        if (kind == "tuplevararg" || kind == "muplevararg") return 3;
+        return 0;
+    }
+
+    template<typename Type>
+    void generate(std::size_t tokens) {
+        store.assign(1, "bench");
+        bool repeated = kind == "multivararg" || kind == "muplevararg";
+        std::size_t w = width();
+        for (std::size_t k = 0; w && store.size() - 1 + w <= tokens && (repeated || k < options); k++) {
+            store.push_back(short_names[k % options]);
+            for (std::size_t i = 1; i < w; i++) store.push_back(value<Type>(store.size()));
+        }
+        while (store.size() - 1 < tokens) store.push_back(value<Type>(store.size()));
+
+        argv.clear();
+        for (std::string & s : store) argv.push_back(&s[0]);
+    }
+};
+
+template<typename Type>
+struct declarations {
+    slots<switcharg<false> > switches;
+    slots<vararg<Type> > varargs;
+    slots<tuplevararg<Type, Type> > tuples;
+    slots<multivararg<Type> > multis;
+    slots<muplevararg<Type, Type> > muples;
+    slots<posarg<Type> > positionals;
+    slots<multiposarg<Type> > multipositionals;
+
+    explicit declarations(std::size_t n) : switches(n), varargs(n), tuples(n), multis(n), muples(n), positionals(n), multipositionals(n) {
+    }
+
+    void declare(arguments & args, const scenario & s, std::size_t tokens) {
+        for (std::size_t i = 0; i < s.options; i++) {
+            const std::string & a = s.short_names[i];
+            const std::string & l = s.long_names[i];
+            if (s.kind == "switcharg") switches.emplace(args, a, l, "switch");
+            else if (s.kind == "vararg") varargs.emplace(args, a, l, "vararg", Type());
+            else if (s.kind == "tuplevararg") tuples.emplace(args, a, l, "tuplevararg", Type(), Type());
+            else if (s.kind == "multivararg") multis.emplace(args, a, l, "multivararg", Type());
+            else if (s.kind == "muplevararg") muples.emplace(args, a, l, "muplevararg", Type(), Type());
+            else if (s.kind == "posarg") positionals.emplace(args, "posarg", Type());
+            else if (s.kind == "multiposarg") multipositionals.emplace(args, "multiposarg", Type(), i + 1 < s.options ? int(tokens / s.options) : 0);
+        }
+    }
+
+    void clear() {
+        switches.clear();
+        varargs.clear();
+        tuples.clear();
+        multis.clear();
+        muples.clear();
+        positionals.clear();
+        multipositionals.clear();
+    }
+};
+
+template<typename Type>
+void run(const std::string & kind, std::size_t options, std::size_t tokens) {
+    scenario s(kind, options);
+    s.generate<Type>(tokens);
+    declarations<Type> d(options);
+
+    // repeat until the measurement takes about 50 ms
+    std::size_t repeat = 0, allocated = 0, peak = 0;
+    std::chrono::duration<double, std::nano> elapsed(0);
+    while (repeat == 0 || (elapsed.count() < 5e7 && repeat < 1000)) {
+        std::size_t before = allocations;
+        heap_peak = heap_current;
+        std::size_t base = heap_current;
+
+        auto start = std::chrono::steady_clock::now();
+        {
+            arguments args(int(s.argv.size()), s.argv.data());
+            d.declare(args, s, tokens);
+            d.clear();
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+
+        allocated = allocations - before;
+        peak = heap_peak - base;
+        repeat++;
+    }
+
+    std::cout << std::left << std::setw(13) << kind << std::setw(8) << type_label<Type>()
+            << std::right << std::setw(8) << options << std::setw(9) << tokens
+            << std::setw(12) << std::fixed << std::setprecision(1) << elapsed.count() / repeat / tokens
+            << std::setw(12) << allocated
+            << std::setw(12) << std::setprecision(1) << peak / 1024.0 << std::endl;
+}
+
+int main(int argc, char** argv) {
+    arguments args(argc, argv);
+    switcharg<false> help(args, "-h", "--help", "print help message");
+    vararg<std::string> only_kind(args, "-k", "--kind", "only this option kind", "");
+    vararg<std::string> only_type(args, "-t", "--type", "only this value type (int, double, string)", "");
+    vararg<std::size_t> max_tokens(args, "-n", "--tokens", "largest token count", 1000000);
+    vararg<std::size_t> max_options(args, "-o", "--options", "largest option count", 1000);
+
+    if (*help) {
+        args.print_help(std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    std::cout << std::left << std::setw(13) << "kind" << std::setw(8) << "type"
+            << std::right << std::setw(8) << "options" << std::setw(9) << "tokens"
+            << std::setw(12) << "ns/token" << std::setw(12) << "allocs" << std::setw(12) << "peak KB" << std::endl;
+
+    const char* kinds[] = {"switcharg", "vararg", "multivararg", "tuplevararg", "muplevararg", "posarg", "multiposarg"};
+    for (const char* kind : kinds) {
+        if (!only_kind.val().empty() && *only_kind != kind) continue;
+        for (std::size_t options = 1; options <= *max_options; options *= 10)
+            for (std::size_t tokens = 10; tokens <= *max_tokens; tokens *= 10) {
+                if (only_type.val().empty() || *only_type == "int") run<int>(kind, options, tokens);
+                if (only_type.val().empty() || *only_type == "double") run<double>(kind, options, tokens);
+                if (only_type.val().empty() || *only_type == "string") run<std::string>(kind, options, tokens);
+            }
+    }
+
+#if !defined(_WIN32)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::cout << "peak resident set size " << usage.ru_maxrss << " KB" << std::endl;
+#endif
+}
@@ -0,0 +1,113 @@
+// ///////////////////////////// MIT License //////////////////////////////////// //
+//                                                                                //
+// Copyright (c) 2013 David Zsolt Manrique                                        //
+//                    david.zsolt.manrique@gmail.com                              //
+//                                                                                //
+// Permission is hereby granted, free of charge, to any person obtaining a copy   //
+// of this software and associated documentation files (the "Software"), to deal  //
+// in the Software without restriction, including without limitation the rights   //
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      //
+// copies of the Software, and to permit persons to whom the Software is          //
+// furnished to do so, subject to the following conditions:                       //
+//                                                                                //
+// The above copyright notice and this permission notice shall be included in     //
+// all copies or substantial portions of the Software.                            //
+//                                                                                //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    //
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  //
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN      //
+// THE SOFTWARE.                                                                  //
+//                                                                                //
+// ////////////////////////////////////////////////////////////////////////////// //
+
+
+// listvararg against multivararg on 10^4 - 10^6 values
+// built by the bench_listvararg target of CMakeLists.txt (Release by default):
+//
+//   cmake -S . -B build && cmake --build build --target bench_listvararg && build/bench_listvararg
+
+#include "cmdl.h"
+
+#include <chrono>
+
+using namespace cmdl;
+
+//! command line of a single list token: -l v0,v1,...
+//! and of one option per value: -m v0 -m v1 ...
+
+struct command_lines {
+    std::vector<std::string> list_store, multi_store;
+    std::vector<char*> list_argv, multi_argv;
+
+    command_lines(const std::vector<std::string> & values) {
+        std::string list;
+        for (const std::string & v : values) {
+            if (!list.empty()) list += ',';
+            list += v;
+        }
+        list_store = {"bench", "-l", list};
+
+        multi_store.push_back("bench");
+        for (const std::string & v : values) {
+            multi_store.push_back("-m");
+            multi_store.push_back(v);
+        }
+
+        for (std::string & s : list_store) list_argv.push_back(&s[0]);
+        for (std::string & s : multi_store) multi_argv.push_back(&s[0]);
+    }
+};
+
+template<typename Function>
+double best_of(int repeat, Function f) {
+    double best = 1e300;
+    for (int r = 0; r < repeat; r++) {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double, std::nano> ns = std::chrono::steady_clock::now() - start;
+        best = std::min(best, ns.count());
+    }
+    return best;
+}
+
+template<typename Type>
+void run(const char* type_name, std::size_t n, std::vector<std::string> values) {
+    command_lines lines(values);
+    std::size_t check = 0;
+
+    double list_ns = best_of(5, [&] {
+        arguments args(int(lines.list_argv.size()), lines.list_argv.data());
+        listvararg<Type> l(args, "-l", "--list", "values", Type());
+        check += l.val().size();
+    });
+    double multi_ns = best_of(5, [&] {
+        arguments args(int(lines.multi_argv.size()), lines.multi_argv.data());
+        multivararg<Type> m(args, "-m", "--multi", "values", Type());
+        check += m.val().size();
+    });
+
+    std::cout << std::left << std::setw(8) << type_name << std::right << std::setw(9) << n
+            << std::setw(14) << std::fixed << std::setprecision(1) << list_ns / n
+            << std::setw(16) << multi_ns / n
+            << std::setw(10) << std::setprecision(2) << multi_ns / list_ns << "x" << std::endl;
+    if (check != 10 * n) std::cerr << "unexpected number of values" << std::endl;
+}
+
+int main() {
+    std::cout << std::left << std::setw(8) << "type" << std::right << std::setw(9) << "values"
+            << std::setw(14) << "listvararg" << std::setw(16) << "multivararg" << std::setw(11) << "speedup" << std::endl;
+    std::cout << std::setw(31) << "ns/value" << std::setw(16) << "ns/value" << std::endl;
+
+    for (std::size_t n = 10000; n <= 1000000; n *= 10) {
+        std::vector<std::string> ints, doubles;
+        for (std::size_t i = 0; i < n; i++) {
+            ints.push_back(std::to_string(i * 7919 % 1000003));
+            doubles.push_back(std::to_string(double(i) * 0.001 - 3.5));
+        }
+        run<int>("int", n, ints);
+        run<double>("double", n, doubles);
+    }
+}
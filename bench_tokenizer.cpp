@@ -0,0 +1,118 @@
+// ///////////////////////////// MIT License //////////////////////////////////// //
+//                                                                                //
+// Copyright (c) 2013 David Zsolt Manrique                                        //
+//                    david.zsolt.manrique@gmail.com                              //
+//                                                                                //
+// Permission is hereby granted, free of charge, to any person obtaining a copy   //
+// of this software and associated documentation files (the "Software"), to deal  //
+// in the Software without restriction, including without limitation the rights   //
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      //
+// copies of the Software, and to permit persons to whom the Software is          //
+// furnished to do so, subject to the following conditions:                       //
+//                                                                                //
+// The above copyright notice and this permission notice shall be included in     //
+// all copies or substantial portions of the Software.                            //
+//                                                                                //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    //
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  //
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN      //
+// THE SOFTWARE.                                                                  //
+//                                                                                //
+// ////////////////////////////////////////////////////////////////////////////// //
+
+
+
+// tokenizer benchmark on one generated multi-megabyte command line
+// the istream_iterator split (the original string constructor) against the quote-aware
+// shell_tokenizer and the whole arguments constructor (tokenizing and indexing), once on a
+// line of plain tokens and once on a line where about every fourth token is quoted or escaped.
+// the istream_iterator split does not remove quotes, so its token counts differ on that line.
+//
+//   bench_tokenizer                      8 MB lines
+//   bench_tokenizer -s 64 -r 10
+
+#include "cmdl.h"
+
+#include <chrono>
+#include <random>
+
+using namespace cmdl;
+
+//! a command line of about size bytes, every quoted-th token is quoted or escaped (0: none)
+
+std::string command_line(std::mt19937 & rng, std::size_t size, unsigned quoted) {
+    std::string line = "tool";
+    for (std::size_t i = 0; line.size() < size; i++) {
+        std::string item = "/data/run" + std::to_string(rng() % 1000) + "/sample_" + std::to_string(i) + ".dat";
+        switch (quoted && rng() % quoted == 0 ? rng() % 3 : 3) {
+            case 0: line += " -i '" + item + " copy'";
+                break;
+            case 1: line += " --label \"run \\\"" + std::to_string(i) + "\\\" of the night\"";
+                break;
+            case 2: line += " -o my\\ " + item;
+                break;
+            default: line += " -i " + item;
+                break;
+        }
+    }
+    return line;
+}
+
+template<typename Function>
+void measure(const std::string & method, const std::string & line, unsigned repeat, Function split) {
+    std::size_t tokens = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned r = 0; r < repeat; r++) tokens = split(line);
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+
+    std::cout << std::left << std::setw(32) << method << std::right << std::setw(12) << seconds.count() / repeat * 1e3
+            << std::setw(12) << double(line.size()) * repeat / seconds.count() / 1e6 << std::setw(12) << tokens << std::endl;
+}
+
+int main(int argc, char** argv) {
+    arguments args(argc, argv);
+    switcharg<false> help(args, "-h", "--help", "print help message");
+    vararg<std::size_t> megabytes(args, "-s", "--size", "size of the command line in MB", 8);
+    vararg<unsigned> repeat(args, "-r", "--repeat", "number of repetitions", 5);
+
+    if (*help) {
+        args.print_help(std::cout);
+        return EXIT_SUCCESS;
+    }
+
+    std::mt19937 rng(1);
+    std::cout << std::left << std::setw(32) << "method" << std::right << std::setw(12) << "ms"
+            << std::setw(12) << "MB/s" << std::setw(12) << "tokens" << std::endl;
+
+    for (unsigned quoted : {0u, 4u}) {
+        const std::string line = command_line(rng, *megabytes << 20, quoted);
+        const std::string input = quoted ? ", quoted" : ", plain";
+
+        measure("istream_iterator" + input, line, *repeat, [](const std::string & line) {
+            std::istringstream iss(line);
+            std::vector<std::string> tokens;
+            std::copy(std::istream_iterator<std::string>(iss), std::istream_iterator<std::string>(), std::back_inserter(tokens));
+            return tokens.size();
+        });
+
+        std::string buffer;
+        std::size_t tokens = 0;
+        measure("shell_tokenizer" + input, line, *repeat, [&](const std::string & line) {
+            buffer = line;
+            tokens = 0;
+            shell_tokenizer::split(&buffer[0], &buffer[0] + buffer.size(), false, [&tokens](std::string_view, bool) {
+                tokens++;
+            });
+            return tokens;
+        });
+
+        // the same tokens, listing them would cost more than the constructor
+        measure("arguments" + input, line, *repeat, [&tokens](const std::string & line) {
+            arguments parsed(line);
+            return tokens;
+        });
+    }
+}
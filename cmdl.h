@@ -23,6 +23,7 @@
 //                                                                                //
 // ////////////////////////////////////////////////////////////////////////////// //
 
+
 #ifndef COMMAND_LINE_ARGUMENT_H
 #define COMMAND_LINE_ARGUMENT_H
 
@@ -30,151 +31,2171 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <list>
+#include <deque>
 #include <iomanip>
 #include <stdexcept>
 #include <tuple>
 #include <regex>
+#include <iterator>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <type_traits>
+#include <utility>
+#include <cstring>
+#include <memory>
+#include <memory_resource>
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <climits>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef CMDL_STATS
+#include <chrono>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define CMDL_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace cmdl {
 
-    template<typename OFirstType>
-    bool obtain(std::istream & is, OFirstType& ofirstvalue) {
-        return is >> ofirstvalue;
+    //!
+    //!  value conversion
+    //!  converter<Type>::convert turns one whole command line token into a value.
+    //!  numbers go through std::from_chars, strings are taken as they are, and any other
+    //!  type falls back to its operator>>. specialize converter for own types.
+    //!
+
+    template<typename Type, typename Enable = void>
+    struct converter {
+
+        static bool convert(std::string_view token, Type & value) {
+            std::istringstream is{std::string(token)};
+            return bool(is >> value);
+        }
+    };
+
+    template<typename Type>
+    struct converter<Type, typename std::enable_if<std::is_arithmetic<Type>::value && !std::is_same<Type, bool>::value && sizeof (Type) != sizeof (char)>::type> {
+
+        static bool convert(std::string_view token, Type & value) {
+            if (token.size() > 1 && token[0] == '+' && token[1] != '-') token.remove_prefix(1);
+            const char* last = token.data() + token.size();
+            std::from_chars_result result = std::from_chars(token.data(), last, value);
+            return result.ec == std::errc() && result.ptr == last;
+        }
+
+        //! the syntax of convert, without converting: out of range numbers pass
+
+        static bool check(std::string_view token) {
+            if (token.size() > 1 && token[0] == '+' && token[1] != '-') token.remove_prefix(1);
+            const char* p = token.data(), * end = p + token.size();
+            if (p != end && *p == '-' && std::is_signed<Type>::value) p++;
+
+            auto digits = [&p, end]() {
+                const char* begin = p;
+                while (p != end && static_cast<unsigned char> (*p - '0') < 10) p++;
+                return p != begin;
+            };
+            if (std::is_integral<Type>::value) return digits() && p == end;
+
+            bool mantissa = digits();
+            if (p != end && *p == '.') {
+                p++;
+                mantissa = digits() || mantissa;
+            }
+            if (!mantissa) {
+                Type value;
+                return convert(token, value); // inf and nan
+            }
+            if (p != end && (*p == 'e' || *p == 'E')) {
+                p++;
+                if (p != end && (*p == '+' || *p == '-')) p++;
+                if (!digits()) return false;
+            }
+            return p == end;
+        }
+    };
+
+    template<typename Type>
+    struct converter<Type, typename std::enable_if<std::is_arithmetic<Type>::value && !std::is_same<Type, bool>::value && sizeof (Type) == sizeof (char)>::type> {
+
+        static bool convert(std::string_view token, Type & value) {
+            if (token.size() != 1) return false;
+            value = static_cast<Type> (token[0]);
+            return true;
+        }
+    };
+
+    template<>
+    struct converter<bool> {
+
+        static bool convert(std::string_view token, bool & value) {
+            if (token != "0" && token != "1") return false;
+            value = token[0] == '1';
+            return true;
+        }
+    };
+
+    template<>
+    struct converter<std::string> {
+
+        static bool convert(std::string_view token, std::string & value) {
+            value.assign(token.data(), token.size());
+            return true;
+        }
+    };
+
+    template<>
+    struct converter<std::pmr::string> {
+
+        static bool convert(std::string_view token, std::pmr::string & value) {
+            value.assign(token.data(), token.size());
+            return true;
+        }
+    };
+
+    template<>
+    struct converter<std::string_view> {
+
+        static bool convert(std::string_view token, std::string_view & value) {
+            value = token;
+            return true;
+        }
+    };
+
+    template<typename Type>
+    bool convert(std::string_view token, Type & value) {
+        return converter<Type>::convert(token, value);
+    }
+
+    template<typename Type, typename Enable = void>
+    struct has_check : std::false_type {
+    };
+
+    template<typename Type>
+    struct has_check<Type, std::void_t<decltype(converter<Type>::check(std::string_view()))> > : std::true_type {
+    };
+
+    //! whether a token converts, by its syntax where the converter can tell it
+    //! @param token command line token
+    //! @param value scratch value for the types that have to be converted to be checked
+
+    template<typename Type>
+    bool check(std::string_view token, Type & value) {
+        if constexpr (has_check<Type>::value)
+            return converter<Type>::check(token);
+        else
+            return convert(token, value);
     }
 
-    template<typename OFirstType, typename... OTypes>
-    bool obtain(std::istream & is, OFirstType& ofirstvalue, OTypes&... ovalues) {
-        return (is >> ofirstvalue) && obtain(is, ovalues...);
+    //! convert consecutive tokens into the elements of a tuple
+    //! @param tokens the tokens, one per element
+
+    template<typename Tuple, std::size_t... I>
+    bool convert_tuple(const std::string_view * tokens, Tuple & value, std::index_sequence<I...>) {
+        return (convert(tokens[I], std::get<I>(value)) && ...);
     }
 
-    class basearg {
-        friend class arguments;
+    //! name of the value type of an argument, for help and completion: bool, char, int, float,
+    //! string or value, the element type for vectors and a comma separated list for tuples.
+    //! the names are compile time constants, nothing is allocated.
+
+    template<typename Type>
+    struct type_name {
+
+        static constexpr std::string_view get() {
+            if constexpr (std::is_same<Type, bool>::value) return "bool";
+            else if constexpr (std::is_arithmetic<Type>::value && sizeof (Type) == sizeof (char)) return "char";
+            else if constexpr (std::is_integral<Type>::value) return "int";
+            else if constexpr (std::is_floating_point<Type>::value) return "float";
+            else if constexpr (std::is_convertible<Type, std::string_view>::value) return "string";
+            else return "value";
+        }
+    };
+
+    template<typename Type, typename Allocator>
+    struct type_name<std::vector<Type, Allocator> > {
+
+        static constexpr std::string_view get() {
+            return type_name<Type>::get();
+        }
+    };
+
+    template<typename FirstType, typename... Types>
+    struct type_name<std::tuple<FirstType, Types...> > {
     protected:
-        std::string _short_name;
-        std::string _long_name;
-        std::string _help_instruction;
-        std::string _arg_type;
-        int _input_number;
+        static constexpr std::size_t size = type_name<FirstType>::get().size() + (std::size_t(0) + ... + (1 + type_name<Types>::get().size()));
+
+        struct joined {
+            char text[size];
+
+            constexpr joined() : text() {
+                std::size_t n = 0;
+                auto append = [this, &n](std::string_view name) {
+                    for (char c : name) text[n++] = c;
+                };
+                append(type_name<FirstType>::get());
+                ((text[n++] = ',', append(type_name<Types>::get())), ...);
+            }
+        };
+        static constexpr joined name{};
+
+    public:
+
+        static constexpr std::string_view get() {
+            return std::string_view(name.text, size);
+        }
+    };
+
+    //! name of the value type in the signature of saved arguments: bool, int32, uint64,
+    //! float64, string, the element type for vectors and a comma separated list for tuples.
+    //! other types are named by the compiler's signature of get(), so that two user types of
+    //! the same size do not match. it is built only when arguments are saved or loaded.
+
+    template<typename Type>
+    struct saved_type_name {
+
+        static std::string get() {
+            if constexpr (std::is_same<Type, bool>::value) return "bool";
+            else if constexpr (std::is_integral<Type>::value)
+                return (std::is_signed<Type>::value ? "int" : "uint") + std::to_string(sizeof (Type) * CHAR_BIT);
+            else if constexpr (std::is_floating_point<Type>::value) return "float" + std::to_string(sizeof (Type) * CHAR_BIT);
+            else if constexpr (std::is_convertible<Type, std::string_view>::value) return "string";
+#if defined(_MSC_VER)
+            else return __FUNCSIG__;
+#elif defined(__GNUC__)
+            else return __PRETTY_FUNCTION__;
+#else
+            else return "value" + std::to_string(sizeof (Type));
+#endif
+        }
+    };
+
+    template<typename Type, typename Allocator>
+    struct saved_type_name<std::vector<Type, Allocator> > {
+
+        static std::string get() {
+            return saved_type_name<Type>::get();
+        }
+    };
+
+    template<typename FirstType, typename... Types>
+    struct saved_type_name<std::tuple<FirstType, Types...> > {
+
+        static std::string get() {
+            return (saved_type_name<FirstType>::get() + ... + ("," + saved_type_name<Types>::get()));
+        }
+    };
+
+    //! the value of one occurrence: the element type of vector valued arguments
+
+    template<typename Type>
+    struct value_element {
+        typedef Type type;
+    };
+
+    template<typename Type, typename Allocator>
+    struct value_element<std::vector<Type, Allocator> > {
+        typedef Type type;
     };
 
     //!
-    //!  command line argument class
-    //!  this contains the argc and argv, and the help message.
+    //!  value serialization
+    //!  serializer<Type> appends a parsed value to a binary blob and reads it back. trivially
+    //!  copyable values are copied as they are, strings and vectors get a 64 bit length in front,
+    //!  so a vector of numbers is read with one memcpy. the blob is meant for the same build on
+    //!  the same machine, it is not a portable format. specialize serializer for own types.
     //!
 
-    class arguments {
-        template<typename T> friend class basetypearg;
+    template<typename Type, typename Enable = void>
+    struct serializer {
+        static const bool supported = std::is_trivially_copyable<Type>::value && !std::is_pointer<Type>::value;
+
+        static void write(std::string & blob, const Type & value) {
+            if constexpr (supported)
+                blob.append(reinterpret_cast<const char*> (&value), sizeof (Type));
+            else
+                throw std::runtime_error("Cannot save " + std::string(type_name<Type>::get()) + " values. Try --help!");
+        }
+
+        static bool read(const char* & p, const char* end, Type & value) {
+            if constexpr (supported) {
+                if (std::size_t(end - p) < sizeof (Type)) return false;
+                std::memcpy(static_cast<void*> (&value), p, sizeof (Type));
+                p += sizeof (Type);
+                return true;
+            } else
+                return false;
+        }
+    };
+
+    //! a bool is one byte, 0 or 1, anything else in a corrupt blob is rejected
+
+    template<>
+    struct serializer<bool> {
+        static const bool supported = true;
+
+        static void write(std::string & blob, bool value) {
+            blob.push_back(value ? '\1' : '\0');
+        }
+
+        static bool read(const char* & p, const char* end, bool & value) {
+            if (p == end || static_cast<unsigned char> (*p) > 1) return false;
+            value = *p++ == 1;
+            return true;
+        }
+    };
+
+    //! length in front of strings and vectors
+
+    inline void write_size(std::string & blob, std::uint64_t size) {
+        blob.append(reinterpret_cast<const char*> (&size), sizeof (size));
+    }
+
+    inline bool read_size(const char* & p, const char* end, std::uint64_t & size) {
+        if (std::size_t(end - p) < sizeof (size)) return false;
+        std::memcpy(&size, p, sizeof (size));
+        p += sizeof (size);
+        return true;
+    }
+
+    template<typename Traits, typename Allocator>
+    struct serializer<std::basic_string<char, Traits, Allocator> > {
+        static const bool supported = true;
+
+        static void write(std::string & blob, const std::basic_string<char, Traits, Allocator> & value) {
+            write_size(blob, value.size());
+            blob.append(value.data(), value.size());
+        }
+
+        static bool read(const char* & p, const char* end, std::basic_string<char, Traits, Allocator> & value) {
+            std::uint64_t size;
+            if (!read_size(p, end, size) || std::uint64_t(end - p) < size) return false;
+            value.assign(p, std::size_t(size));
+            p += size;
+            return true;
+        }
+    };
+
+    //! a string_view is read as a view into the blob
+
+    template<>
+    struct serializer<std::string_view> {
+        static const bool supported = true;
+
+        static void write(std::string & blob, std::string_view value) {
+            write_size(blob, value.size());
+            blob.append(value.data(), value.size());
+        }
+
+        static bool read(const char* & p, const char* end, std::string_view & value) {
+            std::uint64_t size;
+            if (!read_size(p, end, size) || std::uint64_t(end - p) < size) return false;
+            value = std::string_view(p, std::size_t(size));
+            p += size;
+            return true;
+        }
+    };
+
+    template<typename Type, typename Allocator>
+    struct serializer<std::vector<Type, Allocator> > {
+        static const bool supported = serializer<Type>::supported;
+        static const bool copied = std::is_trivially_copyable<Type>::value && !std::is_pointer<Type>::value && !std::is_same<Type, bool>::value;
+
+        static void write(std::string & blob, const std::vector<Type, Allocator> & value) {
+            write_size(blob, value.size());
+            if constexpr (copied)
+                blob.append(reinterpret_cast<const char*> (value.data()), value.size() * sizeof (Type));
+            else
+                for (const Type & element : value) serializer<Type>::write(blob, element);
+        }
+
+        static bool read(const char* & p, const char* end, std::vector<Type, Allocator> & value) {
+            std::uint64_t size;
+            if (!read_size(p, end, size)) return false;
+            value.clear();
+            if constexpr (copied) {
+                if (std::uint64_t(end - p) / sizeof (Type) < size) return false;
+                value.resize(std::size_t(size));
+                std::memcpy(static_cast<void*> (value.data()), p, std::size_t(size) * sizeof (Type));
+                p += size * sizeof (Type);
+            } else if constexpr (std::is_same<Type, bool>::value) {
+                if (std::uint64_t(end - p) < size) return false;
+                for (std::uint64_t i = 0; i < size; i++) {
+                    bool element;
+                    if (!serializer<bool>::read(p, end, element)) return false;
+                    value.push_back(element);
+                }
+            } else {
+                // every element takes at least one byte, which bounds a corrupt size
+                if (std::uint64_t(end - p) < size) return false;
+                value.reserve(std::size_t(size));
+                for (std::uint64_t i = 0; i < size; i++) {
+                    value.emplace_back();
+                    if (!serializer<Type>::read(p, end, value.back())) return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    template<typename... Types>
+    struct serializer<std::tuple<Types...> > {
+        static const bool supported = (serializer<Types>::supported && ...);
+
+        static void write(std::string & blob, const std::tuple<Types...> & value) {
+            std::apply([&blob](const Types & ... elements) {
+                (serializer<Types>::write(blob, elements), ...);
+            }, value);
+        }
+
+        static bool read(const char* & p, const char* end, std::tuple<Types...> & value) {
+            return std::apply([&p, end](Types & ... elements) {
+                return (serializer<Types>::read(p, end, elements) && ...);
+            }, value);
+        }
+    };
+
+    //!
+    //!  list splitter
+    //!  splits the single token of a listvararg into its items. the token is classified in
+    //!  16 byte blocks (with SSE2 when it is available) into bit masks, and the items are found
+    //!  from the separator transitions. items are separated by a comma and/or whitespace,
+    //!  empty items are errors. for integer lists the same pass rejects every character that
+    //!  cannot be part of a number before anything is converted.
+    //!
+
+    class list_splitter {
+        friend class shell_tokenizer;
+    protected:
+
+        struct block_masks {
+            unsigned sep;
+            unsigned comma;
+            unsigned bad;
+        };
+
+        static unsigned popcount(unsigned x) {
+#if defined(__GNUC__)
+            return __builtin_popcount(x);
+#else
+            unsigned n = 0;
+            for (; x; x &= x - 1) n++;
+            return n;
+#endif
+        }
+
+        static unsigned lowest_bit(unsigned x) {
+#if defined(__GNUC__)
+            return __builtin_ctz(x);
+#else
+            unsigned n = 0;
+            for (; !(x & 1); x >>= 1) n++;
+            return n;
+#endif
+        }
+
+        static unsigned below(unsigned i) {
+            return (1u << i) - 1;
+        }
+
+        //! number of set bits, saturated at 2 (only "none", "one" and "more" matter between items)
+
+        static unsigned few(unsigned x) {
+            return (x != 0) + ((x & (x - 1)) != 0);
+        }
+
+        //! classify 16 characters: separators, commas, and characters that are neither
+        //! separators nor part of an integer
+
+        static block_masks classify(const char* p) {
+            block_masks m;
+#ifdef CMDL_SSE2
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*> (p));
+            __m128i comma = _mm_cmpeq_epi8(v, _mm_set1_epi8(','));
+            __m128i space = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                    _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('\t' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('\r' + 1))));
+            __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('9' + 1)));
+            __m128i sign = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('-')), _mm_cmpeq_epi8(v, _mm_set1_epi8('+')));
+            __m128i sep = _mm_or_si128(comma, space);
+            m.sep = unsigned(_mm_movemask_epi8(sep));
+            m.comma = unsigned(_mm_movemask_epi8(comma));
+            m.bad = ~unsigned(_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(sep, digit), sign))) & 0xffffu;
+#else
+            m.sep = m.comma = m.bad = 0;
+            for (unsigned i = 0; i < 16; i++) {
+                char c = p[i];
+                if (c == ',') m.comma |= 1u << i;
+                if (c == ',' || c == ' ' || (c >= '\t' && c <= '\r')) m.sep |= 1u << i;
+                else if (!(c >= '0' && c <= '9') && c != '-' && c != '+') m.bad |= 1u << i;
+            }
+#endif
+            return m;
+        }
+
+        //! classify the block at offset o, padding the tail of the token with spaces
+
+        static block_masks classify(std::string_view token, std::size_t o) {
+            if (token.size() - o >= 16) return classify(token.data() + o);
+            char tail[16];
+            std::memset(tail, ' ', sizeof (tail));
+            std::memcpy(tail, token.data() + o, token.size() - o);
+            return classify(tail);
+        }
+
+    public:
+
+        //! number of items in a list token, used to reserve the result up front
+        //! @param token list token
+
+        static std::size_t count(std::string_view token) {
+            std::size_t n = 0;
+            unsigned carry = 1;
+            for (std::size_t o = 0; o < token.size(); o += 16) {
+                unsigned sep = classify(token, o).sep;
+                n += popcount(~sep & ((sep << 1) | carry) & 0xffffu);
+                carry = sep >> 15;
+            }
+            return n;
+        }
+
+        //! call item(begin, end) for every item of a list token
+        //! @param token list token
+        //! @param integer reject characters that cannot be part of an integer
+        //! @param item returns false to stop on a conversion error
+        //! @return false on a malformed list or a failed item
+
+        template<typename Function>
+        static bool split(std::string_view token, bool integer, Function item) {
+            const char* data = token.data();
+            std::size_t begin = 0;
+            std::size_t commas = 0;
+            bool first = true;
+            bool in_gap = true;
+
+            for (std::size_t o = 0; o < token.size(); o += 16) {
+                block_masks m = classify(token, o);
+                if (integer && m.bad) return false;
+
+                unsigned flips = (m.sep ^ ((m.sep << 1) | (in_gap ? 1u : 0u))) & 0xffffu;
+                unsigned gap = 0;
+                for (; flips; flips &= flips - 1) {
+                    unsigned i = lowest_bit(flips);
+                    if (m.sep >> i & 1) {
+                        if (!item(data + begin, data + o + i)) return false;
+                        first = false;
+                        commas = 0;
+                        gap = i;
+                    } else {
+                        commas += few(m.comma & below(i) & ~below(gap));
+                        if (commas > (first ? 0u : 1u)) return false;
+                        begin = o + i;
+                    }
+                }
+                in_gap = m.sep >> 15 & 1;
+                if (in_gap) commas += few(m.comma & ~below(gap) & 0xffffu);
+            }
+            if (!in_gap) return item(data + begin, data + token.size());
+            return commas == 0;
+        }
+    };
+
+    //!
+    //!  memory mapped file
+    //!  a private, writable mapping: the pages come straight from the page cache and only
+    //!  the ones written to (unquoting in place) are copied.
+    //!
+
+    class mapped_file {
+    protected:
+        char* _data;
+        std::size_t _size;
+#if defined(_WIN32)
+        std::unique_ptr<char[]> _buffer;
+        std::string _id;
+#else
+        dev_t _device;
+        ino_t _inode;
+#endif
+
+    public:
+
+        mapped_file() : _data(nullptr), _size(0) {
+        }
+
+        mapped_file(const mapped_file &) = delete;
+        mapped_file & operator=(const mapped_file &) = delete;
+
+        ~mapped_file() {
+#if !defined(_WIN32)
+            if (_size) munmap(_data, _size);
+#endif
+        }
+
+        //! map a file, false if it cannot be read
+        //! @param path file name
+
+        bool open(const std::string & path) {
+#if defined(_WIN32)
+            std::ifstream is(path, std::ios::binary | std::ios::ate);
+            if (!is) return false;
+            _size = std::size_t(is.tellg());
+            _buffer.reset(new char[_size + 1]);
+            is.seekg(0);
+            if (!is.read(_buffer.get(), _size)) return false;
+            _data = _buffer.get();
+            _id = path;
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat st;
+            if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+                ::close(fd);
+                return false;
+            }
+            _device = st.st_dev;
+            _inode = st.st_ino;
+            if (st.st_size > 0) {
+                void* p = mmap(nullptr, std::size_t(st.st_size), PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                if (p == MAP_FAILED) {
+                    ::close(fd);
+                    return false;
+                }
+                _data = static_cast<char*> (p);
+                _size = std::size_t(st.st_size);
+            }
+            ::close(fd);
+#endif
+            return true;
+        }
+
+        char* data() {
+            return _data;
+        }
+
+        std::size_t size() const {
+            return _size;
+        }
+
+        //! whether both objects map the same file
+
+        bool same(const mapped_file & other) const {
+#if defined(_WIN32)
+            return _id == other._id;
+#else
+            return _device == other._device && _inode == other._inode;
+#endif
+        }
+    };
+
+    //!
+    //!  shell tokenizer
+    //!  splits a writable buffer into tokens in place. whitespace separates tokens, single quotes
+    //!  are literal, double quotes honour \" and \\, a backslash outside quotes escapes the next
+    //!  character (or continues the line), and optionally # starts a comment at the beginning
+    //!  of a token. removing the quotes only moves characters towards the front of the same
+    //!  token, so tokens stay views into the buffer and untouched tokens are never written.
+    //!
+
+    class shell_tokenizer {
     protected:
-        std::string _command_line;
-        std::string _program_name;
-        std::list<std::string> _command_line_args;
 
-        std::vector<basearg*> _defined_args;
+#ifdef CMDL_SSE2
+
+        static __m128i space_mask(__m128i v) {
+            return _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                    _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('\t' - 1)), _mm_cmplt_epi8(v, _mm_set1_epi8('\r' + 1))));
+        }
+
+        //! the characters that end a run of plain token characters: whitespace, quotes, backslash
+
+        static unsigned delimiters(const char* p) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*> (p));
+            __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\'')), _mm_cmpeq_epi8(v, _mm_set1_epi8('"'))),
+                    _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+            return unsigned(_mm_movemask_epi8(_mm_or_si128(space_mask(v), special)));
+        }
+
+        static unsigned non_spaces(const char* p) {
+            return ~unsigned(_mm_movemask_epi8(space_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*> (p))))) & 0xffffu;
+        }
+
+        //! the characters that end a run inside double quotes
+
+        static unsigned double_quoted(const char* p) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*> (p));
+            return unsigned(_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')), _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')))));
+        }
+#endif
+
+        //! first character at or after p that matches, 16 at a time with SSE2
+        //! @param block bit mask of the matching characters of 16
+        //! @param match whether one character matches
+
+        template<typename Block, typename Match>
+        static char* find(char* p, char* end, Block block, Match match) {
+#ifdef CMDL_SSE2
+            for (; end - p >= 16; p += 16)
+                if (unsigned m = block(p)) return p + list_splitter::lowest_bit(m);
+#else
+            (void) block;
+#endif
+            while (p < end && !match(*p)) p++;
+            return p;
+        }
+
+        //! move a run of characters to the write position, untouched when nothing was removed yet
+
+        static void move(char* & w, char* & p, char* q) {
+            if (w != p) std::memmove(w, p, std::size_t(q - p));
+            w += q - p;
+            p = q;
+        }
+
+    public:
+
+        static bool is_space(char c) {
+            return c == ' ' || (c >= '\t' && c <= '\r');
+        }
+
+        //! call on_token(token, quoted) for every token, quoted tells if quotes or escapes were removed.
+        //! whitespace, runs of plain characters and quoted text are skipped in 16 byte blocks.
+        //! @param p beginning of the buffer
+        //! @param end end of the buffer
+        //! @param comments whether # starts a comment
+        //! @return false on an unterminated quote
+
+        template<typename Function>
+        static bool split(char* p, char* end, bool comments, Function on_token) {
+#ifdef CMDL_SSE2
+            auto delimiters = &shell_tokenizer::delimiters;
+            auto non_spaces = &shell_tokenizer::non_spaces;
+            auto double_quoted = &shell_tokenizer::double_quoted;
+#else
+            int delimiters = 0, non_spaces = 0, double_quoted = 0;
+#endif
+            for (;;) {
+                p = find(p, end, non_spaces, [](char c) {
+                    return !is_space(c);
+                });
+                if (p == end) return true;
+                if (comments && *p == '#') {
+                    while (p < end && *p != '\n') p++;
+                    continue;
+                }
+
+                char* begin = p;
+                char* w = p;
+                bool quoted = false, quotes = false;
+                while (p < end && !is_space(*p)) {
+                    if (*p == '\'') {
+                        quoted = quotes = true;
+                        p++;
+                        char* q = static_cast<char*> (std::memchr(p, '\'', std::size_t(end - p)));
+                        if (!q) return false;
+                        move(w, p, q);
+                        p++;
+                    } else if (*p == '"') {
+                        quoted = quotes = true;
+                        for (p++;;) {
+                            move(w, p, find(p, end, double_quoted, [](char c) {
+                                return c == '"' || c == '\\';
+                            }));
+                            if (p == end) return false;
+                            if (*p == '"') break;
+                            if (p + 1 < end && (p[1] == '"' || p[1] == '\\')) p++;
+                            *w++ = *p++;
+                        }
+                        p++;
+                    } else if (*p == '\\') {
+                        quoted = quoted || p + 1 < end;
+                        if (p + 1 < end && p[1] == '\n') {
+                            p += 2;
+                            continue;
+                        }
+                        if (p + 1 < end) p++;
+                        *w++ = *p++;
+                    } else
+                        move(w, p, find(p, end, delimiters, [](char c) {
+                            return is_space(c) || c == '\'' || c == '"' || c == '\\';
+                        }));
+                }
+                // a line continuation alone is no token, an empty pair of quotes is
+                if (w != begin || quotes) on_token(std::string_view(begin, std::size_t(w - begin)), quoted);
+            }
+        }
+    };
+
+#ifdef CMDL_STATS
+
+    //!
+    //!  parse statistics
+    //!  collected only when CMDL_STATS is defined before cmdl.h is included, otherwise none of
+    //!  this is compiled. times are in nanoseconds of std::chrono::steady_clock.
+    //!
+
+    struct option_stats {
+        std::size_t parses = 0;       //!< matches against a command line (parse and update)
+        std::size_t occurrences = 0;  //!< occurrences found on the command line
+        std::size_t conversions = 0;  //!< occurrences converted
+        std::uint64_t parse_ns = 0;   //!< matching, conversions included
+        std::uint64_t convert_ns = 0; //!< conversions only
+    };
+
+    struct parse_stats {
+
+        struct option {
+            std::string kind;
+            std::string short_name;
+            std::string long_name;
+            option_stats stats;
+        };
+
+        std::size_t tokenizations = 0;   //!< command lines tokenized
+        std::size_t tokens = 0;          //!< tokens of the last command line, after @file expansion
+        std::size_t files = 0;           //!< @file response files of the last command line
+        std::uint64_t tokenize_ns = 0;
+        std::size_t declared = 0;        //!< arguments declared
+        std::size_t undeclared = 0;      //!< arguments destroyed
+        std::size_t erasures = 0;        //!< of those, the ones not removed from the back
+        std::size_t allocations = 0;     //!< from the memory resource of the arguments
+        std::size_t allocated_bytes = 0;
+        std::vector<option> options;     //!< the declared arguments, in declaration order
+
+        //! write the statistics as one JSON object
+        //! @param os stream
+
+        void print_json(std::ostream & os) const {
+            auto quote = [](const std::string & text) {
+                std::string quoted = "\"";
+                for (char c : text)
+                    if (c == '"' || c == '\\') quoted.append(1, '\\').append(1, c);
+                    else if (static_cast<unsigned char> (c) < 0x20) quoted.append("\\u00").append(1, "0123456789abcdef"[c >> 4]).append(1, "0123456789abcdef"[c & 15]);
+                    else quoted.push_back(c);
+                return quoted.append(1, '"');
+            };
+
+            std::ostringstream out;
+            out << "{\"tokenizations\":" << tokenizations << ",\"tokens\":" << tokens << ",\"files\":" << files
+                    << ",\"tokenize_ns\":" << tokenize_ns << ",\"declared\":" << declared << ",\"undeclared\":" << undeclared
+                    << ",\"erasures\":" << erasures << ",\"allocations\":" << allocations << ",\"allocated_bytes\":" << allocated_bytes
+                    << ",\"options\":[";
+            for (std::size_t i = 0; i < options.size(); i++) {
+                const option & o = options[i];
+                out << (i ? "," : "") << "{\"kind\":" << quote(o.kind) << ",\"short_name\":" << quote(o.short_name)
+                        << ",\"long_name\":" << quote(o.long_name) << ",\"parses\":" << o.stats.parses
+                        << ",\"occurrences\":" << o.stats.occurrences << ",\"conversions\":" << o.stats.conversions
+                        << ",\"parse_ns\":" << o.stats.parse_ns << ",\"convert_ns\":" << o.stats.convert_ns << "}";
+            }
+            out << "]}";
+            const std::string text = out.str();
+            os.write(text.data(), std::streamsize(text.size()));
+        }
+    };
+
+    //! adds the time from its construction to its destruction to a total
+
+    class stats_timer {
+        std::uint64_t & _total;
+        std::chrono::steady_clock::time_point _start;
+    public:
+
+        explicit stats_timer(std::uint64_t & total) : _total(total), _start(std::chrono::steady_clock::now()) {
+        }
+
+        ~stats_timer() {
+            _total += std::uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now() - _start).count());
+        }
+    };
+
+    //! counts the allocations passed on to the upstream resource
+
+    class counting_resource : public std::pmr::memory_resource {
+        std::pmr::memory_resource * _upstream;
+    public:
+        std::size_t allocations = 0;
+        std::size_t allocated_bytes = 0;
+
+        counting_resource() : _upstream(std::pmr::get_default_resource()) {
+        }
+
+        void upstream(std::pmr::memory_resource * resource) {
+            _upstream = resource;
+        }
+
+    protected:
+
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            allocations++;
+            allocated_bytes += bytes;
+            return _upstream->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+            _upstream->deallocate(p, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource & other) const noexcept override {
+            return this == &other;
+        }
+    };
+#endif
+
+    class basearg {
+        friend class arguments;
+        friend class completer;
+        friend class batch;
+    protected:
+        std::pmr::string _short_name;
+        std::pmr::string _long_name;
+        std::pmr::string _help_instruction;
+        std::pmr::string _arg_type;
+        std::string_view _value_type;
+        int _input_number;
+
+        std::size_t _arity;
+        bool _repeatable;
+        bool _positional;
+
+#ifdef CMDL_STATS
+        mutable option_stats _stats;
+#endif
+
+        explicit basearg(std::pmr::memory_resource * resource) :
+        _short_name(resource), _long_name(resource), _help_instruction(resource), _arg_type(resource), _input_number(0),
+        _arity(0), _repeatable(false), _positional(false) {
+        }
+
+    public:
+
+        virtual ~basearg() {
+        }
+
+        //! reset the value to its default and match it against the current command line
+
+        virtual void parse() = 0;
+
+        //! match against the current command line, converting only when the tokens of this
+        //! argument changed since the last update
+        //! @return whether the value was converted again
+
+        virtual bool update() = 0;
+
+        //! drop what the last update matched, so that the next update converts and reports the
+        //! argument again
+
+        virtual void forget() = 0;
+
+        //! append whether the argument is set and its value to a blob
+        //! @param blob saved arguments
+
+        virtual void save(std::string & blob) const = 0;
+
+        //! read back what save appended
+        //! @param p read position, moved past the value
+        //! @param end end of the blob
+        //! @return false if the blob is too short or the value cannot be read
+
+        virtual bool load(const char* & p, const char* end) = 0;
+
+        //! name of the value type for the signature of saved arguments (saved_type_name)
+
+        virtual std::string saved_type() const = 0;
+    };
+
+    //! a default value, constructed with the memory resource when the type is allocator aware
+    //! (std::pmr::string, std::pmr::vector, ...)
+    //! @param resource memory resource of the arguments
+
+    template<typename Type, typename Enable = void>
+    struct uses_memory_resource : std::false_type {
+    };
+
+    template<typename Type>
+    struct uses_memory_resource<Type, std::void_t<typename Type::allocator_type> > :
+    std::is_convertible<std::pmr::polymorphic_allocator<std::byte>, typename Type::allocator_type> {
+    };
+
+    template<typename Type>
+    struct is_tuple : std::false_type {
+    };
+
+    template<typename... Types>
+    struct is_tuple<std::tuple<Types...> > : std::true_type {
+    };
+
+    template<typename Type>
+    Type make_value(std::pmr::memory_resource * resource) {
+        if constexpr (uses_memory_resource<Type>::value)
+            return Type(typename Type::allocator_type(resource));
+        else if constexpr (is_tuple<Type>::value)
+            return std::apply([resource](const auto & ... elements) {
+                return Type(make_value<typename std::decay<decltype(elements)>::type>(resource)...);
+            }, Type());
+        else
+            return Type();
+    }
+
+    //! a copy of a value, with the memory resource when the type or the elements of a tuple
+    //! are allocator aware
+    //! @param resource memory resource of the arguments
+    //! @param value the value, moved from
+
+    template<typename Type>
+    Type make_value(std::pmr::memory_resource * resource, Type && value) {
+        if constexpr (uses_memory_resource<Type>::value)
+            return Type(std::move(value), typename Type::allocator_type(resource));
+        else if constexpr (is_tuple<Type>::value)
+            return std::apply([resource](auto & ... elements) {
+                return Type(make_value<typename std::decay<decltype(elements)>::type>(resource, std::move(elements))...);
+            }, value);
+        else
+            return std::move(value);
+    }
+
+    template<typename Type>
+    Type make_value(std::pmr::memory_resource * resource, const Type & value) {
+        if constexpr (uses_memory_resource<Type>::value)
+            return Type(value, typename Type::allocator_type(resource));
+        else if constexpr (is_tuple<Type>::value)
+            return std::apply([resource](const auto & ... elements) {
+                return Type(make_value<typename std::decay<decltype(elements)>::type>(resource, elements)...);
+            }, value);
+        else
+            return value;
+    }
+
+    //! a switch value from the environment or a config file
+    //! @param text 1, true, yes, on or 0, false, no, off
+    //! @param value set to the value of the word
+    //! @return false for any other word
+
+    inline bool switch_value(std::string_view text, bool & value) {
+        if (text == "1" || text == "true" || text == "yes" || text == "on") value = true;
+        else if (text == "0" || text == "false" || text == "no" || text == "off") value = false;
+        else return false;
+        return true;
+    }
+
+    //!
+    //!  parse error
+    //!  what went wrong and where: an error code, the position of the offending token in the
+    //!  token table (program name excluded, @file tokens expanded), the token itself, and the
+    //!  argument with its value type and number of values. the views point into the command line
+    //!  and the argument, and stay valid until the next parse. the message is only put together
+    //!  on demand, with the text the exceptions always had.
+    //!
+
+    struct parse_error {
+        enum error_code {
+            none,
+            missing_value,      //!< an option without all of its values in front of "--"
+            multiple,           //!< a single option given more than once
+            conversion,         //!< a value that does not convert to the value type
+            source_value,       //!< a switch set to other than yes/no, or a value with an open quote, in the environment or config file
+            source_count,       //!< a wrong number of values in the environment or config file
+            config_line,        //!< a config file line without '='
+            recursive_file,     //!< a response file that includes itself
+            unterminated_quote, //!< a quote left open in a response file or in the command line
+            exception           //!< any other exception, e.g. out of memory or from a value constructor
+        };
+        static constexpr std::size_t npos = std::size_t(-1);
+
+        error_code code = none;
+        std::size_t token = npos;   //!< position of the token, npos for values from other sources
+        std::string_view text;      //!< the option, value, config line or @file token
+        std::string_view option;    //!< long, else short name of the argument, empty for positionals
+        std::string_view expected;  //!< value type of the argument, e.g. "int" or "int,string"
+        std::size_t arity = 0;      //!< values per occurrence of the argument
+
+        parse_error() {
+        }
+
+        parse_error(error_code c, std::size_t t, std::string_view x) : code(c), token(t), text(x) {
+        }
+
+        explicit operator bool() const {
+            return code != none;
+        }
+
+        std::string message() const {
+            std::string_view name = option;
+            switch (code) {
+                case none: return std::string();
+                case multiple: return "Multiple " + std::string(text) + " command line arguments. Try --help!";
+                case source_value: return "Wrong " + std::string(text) + " value of " + std::string(option) + ". Try --help!";
+                case source_count:
+                    while (!name.empty() && name.front() == '-') name.remove_prefix(1);
+                    return "Wrong " + std::string(name) + " environment or config value. Try --help!";
+                case config_line: return "Wrong " + std::string(text) + " config file line. Try --help!";
+                case recursive_file: return "Recursive " + std::string(text) + " response file. Try --help!";
+                case unterminated_quote:
+                    if (text.empty()) return "Unterminated quote in command line. Try --help!";
+                    return "Unterminated quote in " + std::string(text) + " response file. Try --help!";
+                default: return "Wrong command line arguments. Try --help!";
+            }
+        }
+    };
+
+    //! outcome of a parse that does not throw: empty on success, else the first error
+
+    class parse_result {
+        parse_error _error;
+    public:
+
+        parse_result() {
+        }
+
+        explicit parse_result(const parse_error & error) : _error(error) {
+        }
+
+        bool has_value() const {
+            return !_error;
+        }
+
+        explicit operator bool() const {
+            return !_error;
+        }
+
+        const parse_error & error() const {
+            return _error;
+        }
+    };
+
+    //!
+    //!  token table class
+    //!  the command line is tokenized and classified once (option, value or "--" terminator),
+    //!  and the option tokens are indexed by name, so every declared argument only visits
+    //!  its own occurrences instead of rescanning the whole command line.
+    //!  tokens are non-owning views, the storage belongs to whoever filled the table.
+    //!
+
+    class token_table {
+    public:
+        enum token_kind { value, option, terminator };
+        static constexpr std::size_t npos = std::size_t(-1);
+
+    protected:
+        std::pmr::vector<std::string_view> _text;
+        std::pmr::vector<unsigned char> _kind;
+        std::pmr::vector<std::size_t> _terminators;
+        std::pmr::vector<std::size_t> _index;
+        mutable std::pmr::vector<std::size_t> _next;
+
+        struct index_less {
+            const std::pmr::vector<std::string_view> & text;
+
+            bool operator()(std::size_t a, std::string_view name) const {
+                return text[a] < name;
+            }
+
+            bool operator()(std::string_view name, std::size_t b) const {
+                return name < text[b];
+            }
+        };
+
+        static token_kind classify(std::string_view token) {
+            if (token == "--") return terminator;
+            if (token.size() > 1 && token[0] == '-' && !std::isdigit(static_cast<unsigned char> (token[1])) && token[1] != '.') return option;
+            return value;
+        }
+
+        //! positions of the tokens equal to name, in command line order
+        //! @param name option name
+        //! @param fallback storage for names that are not indexed
+
+        std::pair<const std::size_t*, const std::size_t*> occurrences(std::string_view name, std::pmr::vector<std::size_t> & fallback) const {
+            if (classify(name) == option) {
+                auto range = std::equal_range(_index.begin(), _index.end(), name, index_less{_text});
+                return std::make_pair(_index.data() + (range.first - _index.begin()), _index.data() + (range.second - _index.begin()));
+            }
+            for (std::size_t i = 0; i < _text.size(); i++)
+                if (_kind[i] != terminator && _text[i] == name) fallback.push_back(i);
+            return std::make_pair(fallback.data(), fallback.data() + fallback.size());
+        }
+
+    public:
+
+        explicit token_table(std::pmr::memory_resource * resource = std::pmr::get_default_resource()) :
+        _text(resource), _kind(resource), _terminators(resource), _index(resource), _next(resource) {
+        }
+
+        void push_back(std::string_view token) {
+            _text.push_back(token);
+        }
+
+        //! drop every token, keeping the capacity for the next command line
+
+        void clear() {
+            _text.clear();
+            _kind.clear();
+            _terminators.clear();
+            _index.clear();
+            _next.clear();
+        }
+
+        //! append the "--" sentinel, classify the tokens and build the option index
+
+        void build() {
+            _text.push_back("--");
+            _kind.resize(_text.size());
+            _next.resize(_text.size() + 1);
+            for (std::size_t i = 0; i < _text.size(); i++) {
+                _kind[i] = classify(_text[i]);
+                if (_kind[i] == terminator) _terminators.push_back(i);
+                else if (_kind[i] == option) _index.push_back(i);
+                _next[i] = i;
+            }
+            _next[_text.size()] = _text.size();
+
+            const std::pmr::vector<std::string_view> & text = _text;
+            std::sort(_index.begin(), _index.end(), [&text](std::size_t a, std::size_t b) {
+                int c = text[a].compare(text[b]);
+                return c < 0 || (c == 0 && a < b);
+            });
+        }
+
+        std::size_t size() const {
+            return _text.size();
+        }
+
+        std::string_view operator[](std::size_t i) const {
+            return _text[i];
+        }
+
+        bool is_terminator(std::size_t i) const {
+            return _kind[i] == terminator;
+        }
+
+        bool is_option(std::size_t i) const {
+            return _kind[i] == option;
+        }
+
+        //! first token at or after i that has not been consumed yet
+
+        std::size_t live(std::size_t i) const {
+            while (_next[i] != i) {
+                _next[i] = _next[_next[i]];
+                i = _next[i];
+            }
+            return i;
+        }
+
+        void consume(std::size_t i) {
+            _next[i] = i + 1;
+        }
+
+        //! match an option and its values in front of the "--" cutoff
+        //! @param short_name short version of the switch
+        //! @param long_name long version of the switch
+        //! @param arity number of values following the switch
+        //! @param repeatable whether the switch may occur more than once
+        //! @param error set on a missing value or a repeated single option, which ends the match
+        //! @param on_values called with the positions of the values of every occurrence, false
+        //!        ends the match
+
+        template<typename Function>
+        bool match(std::string_view short_name, std::string_view long_name, std::size_t arity, bool repeatable, parse_error & error, Function on_values) {
+            std::pmr::memory_resource * resource = _text.get_allocator().resource();
+            std::pmr::vector<std::size_t> short_fallback(resource), long_fallback(resource);
+            auto s = occurrences(short_name, short_fallback);
+            auto l = long_name != short_name ? occurrences(long_name, long_fallback) : std::make_pair(s.second, s.second);
+
+            std::size_t inline_values[8];
+            std::pmr::vector<std::size_t> more_values(arity > 8 ? arity : 0, resource);
+            std::size_t * values = arity > 8 ? more_values.data() : inline_values;
+            std::size_t limit = _terminators.front();
+            std::size_t skip = npos;
+            bool found = false;
+
+            while (s.first != s.second || l.first != l.second) {
+                std::size_t o;
+                if (l.first == l.second || (s.first != s.second && *s.first < *l.first)) o = *s.first++;
+                else o = *l.first++;
+
+                if (o > limit) break;
+                if (o == skip || live(o) != o) continue;
+
+                if (found && !repeatable) {
+                    error = parse_error(parse_error::multiple, o, _text[o]);
+                    return false;
+                }
+
+                std::size_t p = o;
+                for (std::size_t k = 0; k < arity; k++) {
+                    p = live(p + 1);
+                    if (_kind[p] == terminator) {
+                        error = parse_error(parse_error::missing_value, o, _text[o]);
+                        return false;
+                    }
+                    values[k] = p;
+                }
+
+                if (!on_values(static_cast<const std::size_t*> (values))) return false;
+
+                consume(o);
+                for (std::size_t k = 0; k < arity; k++) consume(values[k]);
+                found = true;
+
+                // a single-occurrence scan does not revisit the token right after a match,
+                // not even a "--" (the historic list walk stepped over it)
+                if (!repeatable) {
+                    std::size_t t = live(p + 1);
+                    if (t + 1 == _text.size()) break;
+                    skip = t;
+                    if (_kind[t] == terminator) limit = *std::upper_bound(_terminators.begin(), _terminators.end(), t);
+                }
+            }
+            return found;
+        }
+
+        //! tokens that have not been consumed yet, including the "--" sentinel
+
+        std::list<std::string> remaining() const {
+            std::list<std::string> tokens;
+            for (std::size_t i = live(0); i < _text.size(); i = live(i + 1))
+                tokens.emplace_back(_text[i]);
+            return tokens;
+        }
+    };
+
+    //!
+    //!  help_layout class
+    //!  the lines of a help message: the positional arguments, then the options, with each
+    //!  column as wide as its longest entry. the lines of a multi-line help continue under
+    //!  the help column. shared by arguments::help and schema::print_help.
+    //!
+
+    class help_layout {
+    protected:
+
+        struct row {
+            std::string label;
+            std::string_view short_name;
+            std::string_view long_name;
+            std::string_view help;
+        };
+
+        std::vector<row> _positionals;
+        std::vector<row> _options;
+        std::size_t _label_width = 0;
+        std::size_t _short_width = 0;
+        std::size_t _long_width = 0;
+
+        static void pad(std::string & text, std::size_t size, std::size_t width) {
+            text.append(width > size ? width - size : 0, ' ').push_back(' ');
+        }
+
+        static void append_help(std::string & text, std::string_view help, std::size_t column) {
+            for (std::size_t end; (end = help.find('\n')) != std::string_view::npos; help.remove_prefix(end + 1))
+                text.append(help.substr(0, end)).append(1, '\n').append(column, ' ');
+            text.append(help).push_back('\n');
+        }
+
+    public:
+
+        //! @param label e.g. "<arg-1>"
+        //! @param help help instruction
+
+        void positional(std::string label, std::string_view help) {
+            _label_width = std::max(_label_width, label.size());
+            _positionals.push_back(row{std::move(label), std::string_view(), std::string_view(), help});
+        }
+
+        void option(std::string_view short_name, std::string_view long_name, std::string_view help) {
+            _short_width = std::max(_short_width, short_name.size());
+            _long_width = std::max(_long_width, long_name.size());
+            _options.push_back(row{std::string(), short_name, long_name, help});
+        }
+
+        //! append the lines
+        //! @param text help message
+
+        void append(std::string & text) const {
+            for (const row & r : _positionals) {
+                text.append("   ").append(r.label);
+                pad(text, r.label.size(), _label_width);
+                append_help(text, r.help, 3 + _label_width + 1);
+            }
+            for (const row & r : _options) {
+                text.append("   ").append(r.short_name);
+                pad(text, r.short_name.size(), _short_width);
+                text.append(r.long_name);
+                pad(text, r.long_name.size(), _long_width);
+                append_help(text, r.help, 3 + _short_width + 1 + _long_width + 1);
+            }
+        }
+    };
+
+    //!
+    //!  command line argument class
+    //!  this contains the argc and argv, and the help message.
+    //!
+
+    class arguments {
+        template<typename T> friend class basetypearg;
+        template<typename... Options> friend class schema;
+        friend class subcommands;
+        friend class completer;
+    public:
+        //! when the values are converted: at the match, on the first access, or on the first
+        //! access after a syntax check at the match that reports errors right away
+        enum conversion_mode { eager, lazy, lazy_checked };
+
+    protected:
+#ifdef CMDL_STATS
+        counting_resource _counter;
+        parse_stats _stats;
+#endif
+        std::pmr::memory_resource * _resource;
+        conversion_mode _conversion;
+        int _argc;
+        char** _argv;
+        std::pmr::string _buffer;
+        std::vector<std::unique_ptr<mapped_file> > _files;
+        std::string_view _program;
+        mutable std::string _program_name;
+
+        // errors are thrown, except in try_parse, which keeps the first one
+        bool _throwing;
+        parse_error _error;
+        mutable std::string _command_line;
+        token_table _command_line_args;
+
+        std::pmr::vector<basearg*> _defined_args;
+
+        // value sources behind the command line: environment variables with a prefix, and a
+        // key = value config file, indexed on the first lookup
+        std::string _environment_prefix;
+        std::unique_ptr<mapped_file> _config;
+        bool _config_indexed;
+
+        struct config_entry {
+            std::string_view section;
+            std::string_view key;
+            std::string_view value;
+
+            bool operator<(const config_entry & other) const {
+                return section < other.section || (section == other.section && key < other.key);
+            }
+        };
+        std::pmr::vector<config_entry> _config_index;
+
+        // unquoted copies of the environment and config values with quotes or escapes, the
+        // value tokens point into them until the next command line
+        std::pmr::deque<std::pmr::string> _source_values;
+
+        // the mapping of the last loaded arguments file, string_view values point into it
+        std::unique_ptr<mapped_file> _saved;
+
+        static constexpr std::uint32_t saved_version = 1;
+
+        static std::string_view trim(std::string_view text) {
+            while (!text.empty() && std::isspace(static_cast<unsigned char> (text.front()))) text.remove_prefix(1);
+            while (!text.empty() && std::isspace(static_cast<unsigned char> (text.back()))) text.remove_suffix(1);
+            return text;
+        }
+
+        //! one pass over the config file: [section] headers, key = value lines, # and ; comments
+        //! @param error set on a line without '='
+
+        bool index_config(parse_error & error) {
+            _config_index.clear();
+            std::string_view text(_config->data(), _config->size()), section;
+            while (!text.empty()) {
+                std::size_t end = text.find('\n');
+                std::string_view line = trim(text.substr(0, end));
+                text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+
+                if (line.empty() || line[0] == '#' || line[0] == ';') continue;
+                if (line.front() == '[' && line.back() == ']') {
+                    section = trim(line.substr(1, line.size() - 2));
+                    continue;
+                }
+                std::size_t equal = line.find('=');
+                if (equal == std::string_view::npos) {
+                    error = parse_error(parse_error::config_line, parse_error::npos, line);
+                    return false;
+                }
+
+                _config_index.push_back(config_entry{section, trim(line.substr(0, equal)), trim(line.substr(equal + 1))});
+            }
+            std::stable_sort(_config_index.begin(), _config_index.end());
+            _config_indexed = true;
+            return true;
+        }
+
+        //! a config file value without the quotes around it
+
+        static std::string_view unquote(std::string_view value) {
+            if (value.size() > 1 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front())
+                value = value.substr(1, value.size() - 2);
+            return value;
+        }
+
+        //! split a source value into the value tokens of an argument: a single value argument
+        //! takes the whole text, the others split it as the command line, with quotes and
+        //! escapes. a switch takes a yes/no word as its token.
+        //! @return whether the value sets the argument, false with error set for a wrong value
+
+        bool split_source(const basearg & arg, std::string_view text, std::pmr::vector<std::string_view> & tokens, parse_error & error) {
+            if (arg._arity == 0) {
+                bool value;
+                if (text.empty()) return false;
+                if (!switch_value(text, value)) {
+                    error = parse_error(parse_error::source_value, parse_error::npos, text);
+                    return false;
+                }
+                tokens.push_back(text);
+                return true;
+            }
+            if (arg._arity == 1 && !arg._repeatable) {
+                tokens.push_back(text);
+                return true;
+            }
+            if (text.find_first_of("'\"\\") == std::string_view::npos) {
+                for (std::size_t i = 0, n = text.size(); i < n;) {
+                    while (i < n && shell_tokenizer::is_space(text[i])) i++;
+                    std::size_t begin = i;
+                    while (i < n && !shell_tokenizer::is_space(text[i])) i++;
+                    if (i > begin) tokens.push_back(text.substr(begin, i - begin));
+                }
+                return true;
+            }
+
+            std::pmr::string & copy = _source_values.emplace_back(text);
+            if (!shell_tokenizer::split(copy.data(), copy.data() + copy.size(), false, [&tokens](std::string_view token, bool) {
+                    tokens.push_back(token);
+                })) {
+                error = parse_error(parse_error::source_value, parse_error::npos, text);
+                return false;
+            }
+            return true;
+        }
+
+        //! values of an argument that is not on the command line, from the environment variable
+        //! PREFIX_NAME (the long name, upper case, dashes as underscores) or else the config key
+        //! name ([section] name for a long name section.name)
+        //! @param arg argument
+        //! @param tokens the value tokens
+        //! @param error set on a wrong value
+        //! @return whether a source sets the argument
+
+        bool lookup(const basearg & arg, std::pmr::vector<std::string_view> & tokens, parse_error & error) {
+            if (_environment_prefix.empty() && !_config) return false;
+
+            std::string_view name = arg._long_name.empty() ? arg._short_name : arg._long_name;
+            while (!name.empty() && name.front() == '-') name.remove_prefix(1);
+            if (name.empty()) return false;
+
+            bool found = false;
+            if (!_environment_prefix.empty()) {
+                std::string variable = _environment_prefix;
+                for (char c : name) variable.push_back(c == '-' || c == '.' ? '_' : char(std::toupper(static_cast<unsigned char> (c))));
+                const char* value = std::getenv(variable.c_str());
+                if (value && *value) {
+                    found = split_source(arg, value, tokens, error);
+                    if (arg._arity == 0 || error) return found;
+                }
+            }
+
+            if (!found && _config) {
+                if (!_config_indexed && !index_config(error)) return false;
+                std::size_t dot = name.rfind('.');
+                config_entry key{dot == std::string_view::npos ? std::string_view() : name.substr(0, dot), dot == std::string_view::npos ? name : name.substr(dot + 1), std::string_view()};
+                auto range = std::equal_range(_config_index.begin(), _config_index.end(), key);
+                if (range.first != range.second) {
+                    // the last assignment wins, a repeatable argument takes every one
+                    if (!arg._repeatable) range.first = range.second - 1;
+                    // quotes around a single value are dropped, several values are split with them
+                    bool multiple = arg._arity > 1 || arg._repeatable;
+                    for (; range.first != range.second && !error; ++range.first)
+                        found = split_source(arg, multiple ? range.first->value : unquote(range.first->value), tokens, error) || found;
+                }
+            }
+
+            if (found && arg._arity > 0 && (tokens.empty() || tokens.size() % arg._arity != 0 || (!arg._repeatable && tokens.size() != arg._arity))) {
+                error = parse_error(parse_error::source_count, parse_error::npos, std::string_view());
+                return false;
+            }
+            return found && !error;
+        }
+
+        // help and completion data, laid out on first use and dropped when an argument is
+        // declared or destroyed
+        mutable std::string _help;
+        mutable std::string _help_program;
+        mutable std::string _completion;
+
+        //! the memory resource of the arguments, behind an allocation counter with CMDL_STATS
+        //! @param resource memory resource given to the constructor
+
+        std::pmr::memory_resource * instrument(std::pmr::memory_resource * resource) {
+#ifdef CMDL_STATS
+            _counter.upstream(resource);
+            return &_counter;
+#else
+            return resource;
+#endif
+        }
+
+        //! report an error: thrown as std::runtime_error, or kept for try_parse
+        //! @param error what went wrong
+
+        void fail(const parse_error & error) {
+            if (_throwing) throw std::runtime_error(error.message());
+            if (!_error) _error = error;
+        }
+
+        //! report an error of an argument
+        //! @param arg the argument
+        //! @param error what went wrong, without the argument
+
+        void fail(const basearg & arg, parse_error error) {
+            error.option = arg._long_name.empty() ? arg._short_name : arg._long_name;
+            error.expected = arg._value_type;
+            error.arity = arg._arity;
+            fail(error);
+        }
+
+        void declare(basearg * arg) {
+#ifdef CMDL_STATS
+            _stats.declared++;
+#endif
+            _defined_args.push_back(arg);
+            _help.clear();
+            _completion.clear();
+        }
+
+        void undeclare(basearg * arg) {
+#ifdef CMDL_STATS
+            _stats.undeclared++;
+            _stats.erasures += _defined_args.empty() || _defined_args.back() != arg;
+#endif
+            // arguments usually go out of scope in reverse declaration order
+            if (!_defined_args.empty() && _defined_args.back() == arg) _defined_args.pop_back();
+            else _defined_args.erase(std::remove(_defined_args.begin(), _defined_args.end(), arg), _defined_args.end());
+            _help.clear();
+            _completion.clear();
+        }
+
+        //! add a command line token, expanding @file response files
+        //! @param token command line token
+
+        void add(std::string_view token) {
+            if (token.size() > 1 && token[0] == '@') {
+                std::vector<const mapped_file*> including;
+                if (include(token, including)) return;
+            }
+            _command_line_args.push_back(token);
+        }
+
+        //! tokenize a response file into the token table, nested @file tokens are included
+        //! recursively. a file that cannot be read is not an error, its @file token stays
+        //! an ordinary token (as with gcc).
+        //! @param token the @file token
+        //! @param including files on the current include chain, to detect cycles
+
+        bool include(std::string_view token, std::vector<const mapped_file*> & including) {
+            std::unique_ptr<mapped_file> file(new mapped_file);
+            if (!file->open(std::string(token.substr(1)))) return false;
+
+            for (const mapped_file* f : including)
+                if (f->same(*file)) {
+                    fail(parse_error(parse_error::recursive_file, parse_error::npos, token));
+                    return true;
+                }
+
+            mapped_file* current = file.get();
+            _files.push_back(std::move(file));
+            including.push_back(current);
+
+            bool closed = shell_tokenizer::split(current->data(), current->data() + current->size(), true, [&](std::string_view item, bool quoted) {
+                if (!quoted && item.size() > 1 && item[0] == '@' && include(item, including)) return;
+                _command_line_args.push_back(item);
+            });
+            if (!closed)
+                fail(parse_error(parse_error::unterminated_quote, parse_error::npos, token));
+
+            including.pop_back();
+            return true;
+        }
+
+        std::vector<const basearg*> update() {
+            std::vector<const basearg*> changed;
+            try {
+                for (basearg* arg : _defined_args)
+                    if (arg->update()) changed.push_back(arg);
+            } catch (...) {
+                // the caller never sees this diff, the next update reports these arguments again
+                for (basearg* arg : _defined_args)
+                    if (std::find(changed.begin(), changed.end(), arg) != changed.end()) arg->forget();
+                throw;
+            }
+            return changed;
+        }
+
+        void reset() {
+            _files.clear();
+            _source_values.clear();
+            _program = std::string_view();
+            _program_name.clear();
+            _command_line.clear();
+            _command_line_args.clear();
+        }
+
+        //! count the tokens of the command line just tokenized
+
+        void tokenized() {
+#ifdef CMDL_STATS
+            _stats.tokenizations++;
+            _stats.tokens = _command_line_args.size() - 1;
+            _stats.files = _files.size();
+#endif
+        }
+
+        void tokenize(int argc, char** argv) {
+#ifdef CMDL_STATS
+            stats_timer timer(_stats.tokenize_ns);
+#endif
+            reset();
+            _argc = argc;
+            _argv = argv;
+            _program = argv[0];
+            for (int i = 1; i < argc; i++)
+                add(argv[i]);
+            _command_line_args.build();
+            tokenized();
+        }
+
+        template<typename... Source>
+        parse_result parse_quietly(Source... source) {
+            // throwing again when leaving, even by an exception that is not a parse error
+            struct throwing_again {
+                bool & throwing;
+
+                ~throwing_again() {
+                    throwing = true;
+                }
+            } guard{_throwing};
+
+            _throwing = false;
+            _error = parse_error();
+            tokenize(source...);
+            for (basearg* arg : _defined_args) {
+                if (_error) break;
+                arg->parse();
+            }
+            return parse_result(_error);
+        }
+
+        void tokenize(std::string_view cmdline) {
+#ifdef CMDL_STATS
+            stats_timer timer(_stats.tokenize_ns);
+#endif
+            reset();
+            _argc = 0;
+            _argv = nullptr;
+            _buffer.assign(cmdline.data(), cmdline.size());
+
+            // quotes and escapes are removed in place, a quoted @file token stays literal
+            bool first = true, unquoted = false;
+            if (!shell_tokenizer::split(_buffer.data(), _buffer.data() + _buffer.size(), false, [&](std::string_view token, bool quoted) {
+                    if (first) _program = token;
+                    else if (quoted) _command_line_args.push_back(token);
+                    else add(token);
+                    first = false;
+                    unquoted = unquoted || quoted;
+                }))
+                fail(parse_error(parse_error::unterminated_quote, parse_error::npos, std::string_view()));
+            if (unquoted) _command_line.assign(cmdline.data(), cmdline.size());
+            _command_line_args.build();
+            tokenized();
+        }
+
+        //! constructor of a subcommand
+        //! the free tokens of the parent in front of and after its command token are copied into
+        //! one buffer, and the program name becomes the parent program name and the command,
+        //! e.g. "tool build"
+        //! @param parent arguments of the whole command line
+        //! @param command position of the command token in the parent token table
+
+        arguments(const arguments & parent, std::size_t command) :
+        _resource(instrument(parent._resource)), _conversion(parent._conversion), _argc(0), _argv(nullptr), _buffer(_resource), _throwing(true), _command_line_args(_resource), _defined_args(_resource),
+        _config_indexed(false), _config_index(_resource), _source_values(_resource) {
+#ifdef CMDL_STATS
+            stats_timer timer(_stats.tokenize_ns);
+#endif
+            const token_table & tokens = parent._command_line_args;
+            const std::size_t sentinel = tokens.size() - 1;
+
+            std::size_t size = parent._program.size() + 1 + tokens[command].size();
+            for (std::size_t i = tokens.live(0); i < sentinel; i = tokens.live(i + 1))
+                if (i != command) size += 1 + tokens[i].size();
+
+            // reserved up front, so the views taken while appending stay valid
+            _buffer.reserve(size);
+            _buffer.append(parent._program.data(), parent._program.size()).append(1, ' ').append(tokens[command].data(), tokens[command].size());
+            _program = std::string_view(_buffer.data(), _buffer.size());
+            for (std::size_t i = tokens.live(0); i < sentinel; i = tokens.live(i + 1)) {
+                if (i == command) continue;
+                _buffer.append(1, ' ');
+                std::size_t begin = _buffer.size();
+                _buffer.append(tokens[i].data(), tokens[i].size());
+                _command_line_args.push_back(std::string_view(_buffer.data() + begin, tokens[i].size()));
+            }
+            _command_line_args.build();
+            tokenized();
+        }
+
+    public:
+
+        //! constructor
+        //! the tokens are views into argv, which has to outlive this object (as the one of main does),
+        //! or into the memory mapped @file response files
+        //! @param argc number of command line arguments
+        //! @param argv command line arguments
+        //! @param resource memory resource of the token table and of every argument declared on this
+        //!        object, e.g. a std::pmr::monotonic_buffer_resource over a caller provided buffer
+
+        arguments(int argc, char** argv, std::pmr::memory_resource * resource = std::pmr::get_default_resource()) :
+        _resource(instrument(resource)), _conversion(eager), _argc(0), _argv(nullptr), _buffer(_resource), _throwing(true), _command_line_args(_resource), _defined_args(_resource),
+        _config_indexed(false), _config_index(_resource), _source_values(_resource) {
+            tokenize(argc, argv);
+        }
+
+        //! constructor
+        //! the command line is copied once and the tokens are views into that copy. it is split
+        //! as a POSIX shell would: single and double quotes and backslash escapes are removed.
+        //! @param cmdline program name and arguments separated by whitespaces
+        //! @param resource memory resource, as above
+
+        arguments(std::string_view cmdline, std::pmr::memory_resource * resource = std::pmr::get_default_resource()) :
+        _resource(instrument(resource)), _conversion(eager), _argc(0), _argv(nullptr), _buffer(_resource), _throwing(true), _command_line_args(_resource), _defined_args(_resource),
+        _config_indexed(false), _config_index(_resource), _source_values(_resource) {
+            tokenize(cmdline);
+        }
+
+        arguments(const arguments &) = delete;
+        arguments & operator=(const arguments &) = delete;
+
+        //! parse a new command line with the arguments already declared on this object.
+        //! every argument is reset to its default and matched again, in declaration order,
+        //! without being constructed or registered again. if an error is thrown the values
+        //! are unspecified until the next successful parse.
+        //! @param argc number of command line arguments
+        //! @param argv command line arguments, they have to outlive this object or the next parse
+
+        void parse(int argc, char** argv) {
+            parse_result result = try_parse(argc, argv);
+            if (!result) throw std::runtime_error(result.error().message());
+        }
+
+        //! @param cmdline program name and arguments separated by whitespaces
+
+        void parse(std::string_view cmdline) {
+            parse_result result = try_parse(cmdline);
+            if (!result) throw std::runtime_error(result.error().message());
+        }
+
+        //! parse as above, but return the first error instead of throwing it. the arguments after
+        //! the failing one are not matched. lazy values still throw conversion errors on access.
+        //!
+        //!     cmdl::parse_result result = args.try_parse(line);
+        //!     if (!result) log(result.error().token, result.error().message());
+        //!
+        //! @param argc number of command line arguments
+        //! @param argv command line arguments, they have to outlive this object or the next parse
+
+        parse_result try_parse(int argc, char** argv) {
+            return parse_quietly(argc, argv);
+        }
+
+        //! @param cmdline program name and arguments separated by whitespaces
+
+        parse_result try_parse(std::string_view cmdline) {
+            return parse_quietly(cmdline);
+        }
+
+        //! incremental parse of an edited command line. every argument is matched again (through
+        //! the name index, so only its own occurrences are visited), but only those whose tokens
+        //! differ from the previous update are converted, and only they are returned. the first
+        //! update after a construction or parse converts every argument, and the arguments that
+        //! changed in an update that threw are returned by the next one.
+        //! @param argc number of command line arguments
+        //! @param argv command line arguments, they have to outlive this object or the next parse
+        //! @return the arguments whose value changed, in declaration order
+
+        std::vector<const basearg*> update(int argc, char** argv) {
+            tokenize(argc, argv);
+            return update();
+        }
+
+        //! @param cmdline program name and arguments separated by whitespaces, @file response
+        //!        files are read again
+
+        std::vector<const basearg*> update(std::string_view cmdline) {
+            tokenize(cmdline);
+            return update();
+        }
+
+        std::pmr::memory_resource * resource() const {
+            return _resource;
+        }
+
+        //! conversion mode of the arguments matched from now on. in the lazy modes an argument
+        //! only keeps the positions of its tokens, and converts them on the first val() or
+        //! operator*, which then throws the conversion errors. lazy_checked throws malformed
+        //! tokens at the match already (numbers by their syntax, out of range ones on access).
+        //! the first access is not thread safe, and the values stay valid until the next parse.
+        //! @param mode conversion mode
 
-    public:
+        void conversion(conversion_mode mode) {
+            _conversion = mode;
+        }
 
-        arguments(int argc, char** argv) {
-            std::ostringstream os;
+#ifdef CMDL_STATS
 
-            _program_name = argv[0];
-            os << argv[0] << ' ';
+        //! statistics of the parses so far, with the arguments declared now
 
-            for (int i = 1; i < argc; i++) {
-                _command_line_args.push_back(argv[i]);
-                os << argv[i] << ' ';
+        parse_stats stats() const {
+            parse_stats stats = _stats;
+            stats.allocations = _counter.allocations;
+            stats.allocated_bytes = _counter.allocated_bytes;
+            for (const basearg* arg : _defined_args)
+                stats.options.push_back(parse_stats::option{std::string(arg->_arg_type), std::string(arg->_short_name), std::string(arg->_long_name), arg->_stats});
+            return stats;
+        }
+#endif
+
+        //! signature of the declared arguments: kind, names, count and saved value type name
+        //! of every one, in declaration order (64 bit FNV-1a)
+
+        std::uint64_t signature() const {
+            std::uint64_t hash = 14695981039346656037ull;
+            auto mix = [&hash](std::string_view text) {
+                for (char c : text) hash = (hash ^ static_cast<unsigned char> (c)) * 1099511628211ull;
+                hash = (hash ^ 0xff) * 1099511628211ull;
+            };
+            for (const basearg* arg : _defined_args) {
+                mix(arg->_arg_type);
+                mix(arg->_short_name);
+                mix(arg->_long_name);
+                mix(std::to_string(arg->_input_number));
+                mix(arg->saved_type());
             }
-            _command_line_args.push_back("--");
-            _command_line = os.str();
+            return hash;
+        }
+
+        //! the parsed state of every declared argument, values and whether they are set, as a
+        //! binary blob: "CMDL", a version, the signature, then the arguments in declaration order.
+        //! lazy values are converted first. streamposarg values cannot be saved.
+
+        std::string serialize() const {
+            std::string blob("CMDL", 4);
+            std::uint64_t hash = signature(), count = _defined_args.size();
+            blob.append(reinterpret_cast<const char*> (&saved_version), sizeof (saved_version));
+            blob.append(reinterpret_cast<const char*> (&hash), sizeof (hash));
+            blob.append(reinterpret_cast<const char*> (&count), sizeof (count));
+            for (const basearg* arg : _defined_args) arg->save(blob);
+            return blob;
+        }
+
+        //! set the declared arguments from a blob of serialize, instead of parsing. the arguments
+        //! have to be declared in the same way as the saved ones, else nothing is read and an
+        //! error is thrown. string_view values are views into the blob. if a corrupt blob is
+        //! thrown the values are unspecified until the next successful parse or load.
+        //! @param blob saved arguments
+
+        void deserialize(std::string_view blob) {
+            const char* p = blob.data(), * end = p + blob.size();
+            std::uint32_t version;
+            std::uint64_t hash, count;
+            if (blob.size() < 4 + sizeof (version) + sizeof (hash) + sizeof (count) || blob.substr(0, 4) != "CMDL")
+                throw std::runtime_error("Wrong saved arguments. Try --help!");
+            p += 4;
+            std::memcpy(&version, p, sizeof (version));
+            p += sizeof (version);
+            std::memcpy(&hash, p, sizeof (hash));
+            p += sizeof (hash);
+            std::memcpy(&count, p, sizeof (count));
+            p += sizeof (count);
+            if (version != saved_version || hash != signature() || count != _defined_args.size())
+                throw std::runtime_error("Mismatched saved arguments. Try --help!");
+
+            for (basearg* arg : _defined_args)
+                if (!arg->load(p, end))
+                    throw std::runtime_error("Wrong saved arguments. Try --help!");
+            if (p != end)
+                throw std::runtime_error("Wrong saved arguments. Try --help!");
+        }
+
+        //! write serialize() to a file, for worker processes that load it instead of parsing
+        //! the same command line again
+        //! @param path file name
+        //! @return false if the file cannot be written
+
+        bool save(const std::string & path) const {
+            const std::string blob = serialize();
+            std::ofstream os(path, std::ios::binary);
+            return os.write(blob.data(), std::streamsize(blob.size())) && os.flush();
+        }
+
+        //! load a file written by save. the file is memory mapped and kept mapped until the next
+        //! load, so reading it costs about a copy of the values:
+        //!
+        //!     cmdl::arguments args("worker");  // nothing to match
+        //!     cmdl::vararg<int> jobs(args, "-j", "--jobs", "number of jobs", 1);
+        //!     ...
+        //!     args.load("job.args");
+        //!
+        //! @param path file name
+        //! @return false if the file cannot be read
+
+        bool load(const std::string & path) {
+            std::unique_ptr<mapped_file> file(new mapped_file);
+            if (!file->open(path)) return false;
+            deserialize(std::string_view(file->data(), file->size()));
+            _saved = std::move(file);
+            return true;
         }
 
-        arguments(const std::string & cmdline) {
-            _command_line = cmdline;
+        //! take the values of the named arguments that are not on the command line from
+        //! environment variables, e.g. with prefix "TOOL_" --max-jobs is TOOL_MAX_JOBS.
+        //! the command line comes first, then the environment, then the config file. a variable
+        //! set to an empty value counts as not set, for switches and value arguments alike.
+        //! set the sources before declaring the arguments.
+        //! @param prefix prefix of the variable names
 
-            std::istringstream iss(cmdline);
-            std::vector<std::string> args;
-            std::copy(std::istream_iterator<std::string>(iss),
-                    std::istream_iterator<std::string>(),
-                    std::back_inserter<std::vector<std::string> >(args));
+        void environment(std::string_view prefix) {
+            _environment_prefix = prefix;
+        }
 
-            _program_name = args[0];
-            for (int i = 1; i < args.size(); i++)
-                _command_line_args.push_back(args[i]);
-            _command_line_args.push_back("--");
+        //! take the values of the named arguments that are neither on the command line nor in
+        //! the environment from a config file of key = value lines, with optional [section]
+        //! headers for dotted long names. the file is mapped, and indexed by key on the first
+        //! lookup, so only the declared arguments are looked up.
+        //! @param path file name
+        //! @return false if the file cannot be read
+
+        bool config(const std::string & path) {
+            std::unique_ptr<mapped_file> file(new mapped_file);
+            if (!file->open(path)) return false;
+            _config = std::move(file);
+            _config_indexed = false;
+            _config_index.clear();
+            return true;
         }
 
         const std::string & name() const {
+            if (_program_name.empty()) _program_name = _program;
             return _program_name;
         }
 
+        //! command line as a single string, assembled on the first call for argv input
+
         const std::string & cmdline() const {
+            if (!_argv) {
+                if (_command_line.empty()) _command_line = _buffer;
+                return _command_line;
+            }
+            if (_command_line.empty())
+                for (int i = 0; i < _argc; i++)
+                    _command_line.append(_argv[i]).push_back(' ');
             return _command_line;
         }
 
-        const std::list<std::string> & cmdline_args() const {
-            return _command_line_args;
+        std::list<std::string> cmdline_args() const {
+            return _command_line_args.remaining();
         }
 
         void print() const {
-            for (std::list<std::string>::const_iterator it = _command_line_args.begin(); it != _command_line_args.end(); it++)
-                std::cout << *it << std::endl;
+            for (std::size_t i = _command_line_args.live(0); i < _command_line_args.size(); i = _command_line_args.live(i + 1))
+                std::cout << _command_line_args[i] << std::endl;
             std::cout << std::endl;
         }
 
+        //! help message, laid out on the first call with the columns as wide as the longest
+        //! names, and kept until an argument is declared or destroyed
+
+        const std::string & help() const {
+            if (!_help.empty() && _help_program == _program) return _help;
+
+            help_layout layout;
+            std::string usage;
+            int n = 0;
+            for (const basearg* arg : _defined_args)
+                if (arg->_positional) {
+                    std::string label = "<arg-" + std::to_string(++n);
+                    if (arg->_repeatable && arg->_input_number > 0) {
+                        n += arg->_input_number - 1;
+                        label += "..." + std::to_string(n) + ">";
+                    } else if (arg->_repeatable) label += "... >";
+                    else label += ">";
+                    usage.append(label).push_back(' ');
+                    layout.positional(std::move(label), arg->_help_instruction);
+                }
+            for (const basearg* arg : _defined_args)
+                if (!arg->_positional) layout.option(arg->_short_name, arg->_long_name, arg->_help_instruction);
+
+            _help_program = _program;
+            _help.clear();
+            _help.append("Usage: ").append(_program).append(" ").append(usage).append(" -[option] <option-arg>\n");
+            layout.append(_help);
+            return _help;
+        }
+
         //! print help messgae
         //! @param os stream
 
         void print_help(std::ostream & os) const {
+            const std::string & text = help();
+            os.write(text.data(), std::streamsize(text.size()));
+        }
 
-            std::list<std::vector<std::string> > _help;
-            for (std::vector<basearg*> ::const_iterator it = _defined_args.begin(); it != _defined_args.end(); it++) {
-                if ((*it)->_arg_type == "posarg") _help.push_back({(*it)->_help_instruction});
-                else if ((*it)->_arg_type == "multiposarg") _help.push_back({(*it)->_help_instruction, "0"});
-                else _help.push_back({(*it)->_short_name, (*it)->_long_name, (*it)->_help_instruction});
+        //! completion data, one line per argument with tab separated fields:
+        //! kind, short name, long name, arity, value type and help, e.g.
+        //! "vararg\t-n\t--number\t1\tint\tnumber of jobs". positional arguments have empty names
+        //! and their maximum count (0 for any) as arity. tabs, new lines and backslashes in the
+        //! help are escaped as \t, \n and \\.
+
+        const std::string & completion() const {
+            if (!_completion.empty() || _defined_args.empty()) return _completion;
+
+            for (const basearg* arg : _defined_args) {
+                _completion.append(arg->_arg_type).push_back('\t');
+                _completion.append(arg->_short_name).push_back('\t');
+                _completion.append(arg->_long_name).push_back('\t');
+                _completion.append(std::to_string(arg->_positional ? arg->_input_number : int(arg->_arity))).push_back('\t');
+                if (arg->_arity > 0) _completion.append(arg->_value_type);
+                _completion.push_back('\t');
+                for (char c : arg->_help_instruction)
+                    if (c == '\t') _completion.append("\\t");
+                    else if (c == '\n') _completion.append("\\n");
+                    else if (c == '\\') _completion.append("\\\\");
+                    else _completion.push_back(c);
+                _completion.push_back('\n');
             }
+            return _completion;
+        }
 
-            int n = 0;
-            os << "Usage: " << _program_name << ' ';
-            for (std::list<std::vector<std::string> > ::const_iterator it = _help.begin(); it != _help.end(); it++)
-                if (it->size() == 1) os << "<arg-" << ++n << ">" << ' ';
-                else if (it->size() == 2 && (*it)[1] != "0") {
-                    os << "<arg-" << ++n << "...";
-                    std::istringstream is((*it)[1]);
-                    int dn = 0;
-                    is >> dn;
-                    n += dn;
-                    os << n << ">" << ' ';
-                } else if (it->size() == 2 && (*it)[1] == "0") {
-                    os << "<arg-" << ++n << "... >" << ' ';
-                }
-            os << " -[option] <option-arg>" << std::endl;
-            n = 0;
-            for (std::list<std::vector<std::string> > ::const_iterator it = _help.begin(); it != _help.end(); it++)
-                if (it->size() == 1) {
-                    std::ostringstream oss;
-                    oss << "<arg-" << ++n << ">";
-                    os << "   " << std::left << std::setw(15) << oss.str() << ' ' << std::left << std::setw(50) << (*it)[0] << std::endl;
-                } else if (it->size() == 2 && (*it)[1] != "0") {
-                    std::ostringstream oss;
-                    oss << "<arg-" << ++n << "...";
-                    std::istringstream is((*it)[1]);
-                    int dn = 0;
-                    is >> dn;
-                    n += dn;
-                    oss << n << ">";
-                    os << "   " << std::left << std::setw(15) << oss.str() << ' ' << std::left << std::setw(50) << (*it)[0] << std::endl;
-                } else if (it->size() == 2 && (*it)[1] == "0") {
-                    std::ostringstream oss;
-                    oss << "<arg-" << ++n << "... >";
-                    os << "   " << std::left << std::setw(15) << oss.str() << ' ' << std::left << std::setw(50) << (*it)[0] << std::endl;
-                }
-            for (std::list<std::vector<std::string> > ::const_iterator it = _help.begin(); it != _help.end(); it++)
-                if (it->size() == 3) {
-                    os << "   " << std::left << std::setw(5) << (*it)[0] << ' ';
-                    os << std::left << std::setw(20) << (*it)[1] << ' ';
-                    os << std::left << std::setw(50) << (*it)[2] << std::endl;
-                }
+        void print_completion(std::ostream & os) const {
+            const std::string & text = completion();
+            os.write(text.data(), std::streamsize(text.size()));
         }
 
         void print_all() {
@@ -187,38 +2208,305 @@ namespace cmdl {
     template<typename BaseType>
     class basetypearg : public basearg {
     protected:
-        BaseType _var;
+        // the value is filled in on the first access after a lazy match, so the conversion
+        // hooks are const and the state they fill is mutable
+        mutable BaseType _var;
         bool _found;
 
-        std::list<std::string> &_command_line_args;
-        std::vector<basearg*> & _defined_args;
+        token_table &_command_line_args;
+        arguments & _arguments;
+
+        // tokens consumed at the last update, to tell whether the value has to change
+        bool _fingerprinted;
+        std::pmr::string _fingerprint;
+        std::pmr::string _scratch;
+        std::pmr::vector<std::size_t> _positions;
+
+        // positions are matched but not converted yet (lazy conversion)
+        mutable bool _pending;
+
+        // value tokens of one occurrence, and the ones from the environment or config file
+        mutable std::pmr::vector<std::string_view> _values;
+        std::pmr::vector<std::string_view> _fallback;
+
+        //! set the value to the default of an argument that is not on the command line
+
+        virtual void reset() const = 0;
+
+        //! convert one occurrence
+        //! @param values its value tokens
+        //! @return false if they do not convert
+
+        virtual bool assign(const std::string_view * values) const = 0;
+
+        //! complete the value once all occurrences are assigned
+
+        virtual void finish() const {
+        }
+
+        //! check that one occurrence converts, without keeping the value
+        //! @param values its value tokens
+
+        virtual bool check(const std::string_view * values) const {
+            if (_arity == 0) return true;
+            typename value_element<BaseType>::type value{};
+            return check_values(values, value);
+        }
+
+        template<typename Type>
+        bool check_values(const std::string_view * values, Type & value) const {
+            return cmdl::check(values[0], value);
+        }
+
+        template<typename... Types, std::size_t... I>
+        bool check_values(const std::string_view * values, std::tuple<Types...> & value, std::index_sequence<I...>) const {
+            return (cmdl::check(values[I], std::get<I>(value)) && ...);
+        }
+
+        template<typename... Types>
+        bool check_values(const std::string_view * values, std::tuple<Types...> & value) const {
+            return check_values(values, value, std::index_sequence_for<Types...>());
+        }
+
+        //! the value tokens of one occurrence on the command line
+        //! @param it positions of its values
+
+        const std::string_view * values_at(const std::size_t * it) const {
+            for (std::size_t k = 0; k < _arity; k++) _values[k] = _command_line_args[it[k]];
+            return _values.data();
+        }
+
+        //! look the argument up in the environment and the config file of the arguments, when
+        //! it is not on the command line
+
+        bool fall_back(parse_error & error) {
+            _fallback.clear();
+            return !_positional && _arguments.lookup(*this, _fallback, error);
+        }
+
+        //! convert one occurrence, timed with CMDL_STATS
+        //! @param values its value tokens
+
+        bool convert_values(const std::string_view * values) const {
+#ifdef CMDL_STATS
+            stats_timer timer(_stats.convert_ns);
+            _stats.conversions++;
+#endif
+            return assign(values);
+        }
+
+        bool assign_fallback(parse_error & error) const {
+            if (_arity > 0)
+                for (std::size_t i = 0; i < _fallback.size(); i += _arity)
+                    if (!convert_values(_fallback.data() + i)) {
+                        error = parse_error(parse_error::conversion, parse_error::npos, _fallback[i]);
+                        return false;
+                    }
+            return true;
+        }
+
+        //! convert the positions kept by a lazy match
+
+        bool convert_pending() const {
+            reset();
+            parse_error error;
+            if (_arity > 0)
+                for (std::size_t i = 0; i < _positions.size() && !error; i += _arity)
+                    if (!convert_values(values_at(_positions.data() + i)))
+                        error = parse_error(parse_error::conversion, _positions[i], _command_line_args[_positions[i]]);
+            if (!error) assign_fallback(error);
+            if (error) {
+                _arguments.fail(*this, error);
+                return false;
+            }
+            finish();
+            _pending = false;
+            return true;
+        }
+
+        //! find the occurrences on the command line and consume their tokens. positional
+        //! arguments take the leading free tokens in front of the "--" cutoff, up to
+        //! _input_number of them (0 is any number)
+        //! @param error set when the match fails
+        //! @param on_values called with the positions of the values of every occurrence, false
+        //!        ends the match
+
+        template<typename Function>
+        bool match(parse_error & error, Function on_values) {
+#ifdef CMDL_STATS
+            _stats.parses++;
+            auto counted = [this, &on_values](const std::size_t * it) {
+                _stats.occurrences++;
+                return on_values(it);
+            };
+            return match_occurrences(error, counted);
+#else
+            return match_occurrences(error, on_values);
+#endif
+        }
+
+        template<typename Function>
+        bool match_occurrences(parse_error & error, Function & on_values) {
+            if (!_positional)
+                return _command_line_args.match(_short_name, _long_name, _arity, _repeatable, error, on_values);
+
+            std::size_t n = 0;
+            for (std::size_t it = _command_line_args.live(0); !_command_line_args.is_terminator(it); it = _command_line_args.live(it + 1)) {
+                if (!on_values(&it)) return false;
+                _command_line_args.consume(it);
+                if (++n == std::size_t(_input_number)) break;
+            }
+            return n > 0;
+        }
+
     public:
 
         basetypearg(arguments & args,
-                const std::string & short_name,
-                const std::string & long_name,
-                const std::string & help_instruction,
-                const std::string & arg_type, const int input_number) : _command_line_args(args._command_line_args), _defined_args(args._defined_args) {
-
-            _defined_args.push_back(this);
+                std::string_view short_name,
+                std::string_view long_name,
+                std::string_view help_instruction,
+                std::string_view arg_type, const int input_number,
+                bool repeatable = false, bool positional = false) :
+        basearg(args._resource), _var(make_value<BaseType>(args._resource)), _found(false), _command_line_args(args._command_line_args), _arguments(args),
+        _fingerprinted(false), _fingerprint(args._resource), _scratch(args._resource), _positions(args._resource), _pending(false),
+        _values(positional ? 1 : std::size_t(input_number), args._resource), _fallback(args._resource) {
 
             this->_short_name = short_name;
             this->_long_name = long_name;
             this->_help_instruction = help_instruction;
             this->_arg_type = arg_type;
+            this->_value_type = type_name<BaseType>::get();
             this->_input_number = input_number;
+            this->_arity = positional ? 1 : std::size_t(input_number);
+            this->_repeatable = repeatable;
+            this->_positional = positional;
 
+            _arguments.declare(this);
         }
 
         ~basetypearg() {
-            _defined_args.erase(std::remove(_defined_args.begin(), _defined_args.end(), this), _defined_args.end());
+            _arguments.undeclare(this);
+        }
+
+        void parse() override {
+#ifdef CMDL_STATS
+            stats_timer timer(_stats.parse_ns);
+#endif
+            _fingerprinted = false;
+            _pending = false;
+            _fallback.clear();
+            parse_error error;
+            if (_arguments._conversion == arguments::eager) {
+                reset();
+                _found = match(error, [this, &error](const std::size_t * it) {
+                    if (convert_values(values_at(it))) return true;
+                    error = parse_error(parse_error::conversion, it[0], _command_line_args[it[0]]);
+                    return false;
+                });
+                if (!error && !_found && fall_back(error) && assign_fallback(error)) _found = true;
+                if (error) {
+                    _arguments.fail(*this, error);
+                    return;
+                }
+                finish();
+                return;
+            }
+
+            const bool checked = _arguments._conversion == arguments::lazy_checked;
+            _positions.clear();
+            _found = match(error, [this, checked, &error](const std::size_t * it) {
+                _positions.insert(_positions.end(), it, it + _arity);
+                if (!checked || check(values_at(it))) return true;
+                error = parse_error(parse_error::conversion, it[0], _command_line_args[it[0]]);
+                return false;
+            });
+            if (!error && !_found && fall_back(error)) {
+                if (checked && _arity > 0)
+                    for (std::size_t i = 0; i < _fallback.size() && !error; i += _arity)
+                        if (!check(_fallback.data() + i)) error = parse_error(parse_error::conversion, parse_error::npos, _fallback[i]);
+                _found = !error;
+            }
+            if (error) {
+                _arguments.fail(*this, error);
+                return;
+            }
+            _pending = true;
+        }
+
+        //! match again, and convert only if the consumed tokens differ from the last update
+
+        bool update() override {
+#ifdef CMDL_STATS
+            stats_timer timer(_stats.parse_ns);
+#endif
+            _scratch.clear();
+            _positions.clear();
+            parse_error error;
+            bool found = match(error, [this](const std::size_t * it) {
+                for (std::size_t k = 0; k < _arity; k++) {
+                    std::string_view token = _command_line_args[it[k]];
+                    _positions.push_back(it[k]);
+                    std::size_t size = token.size();
+                    _scratch.append(reinterpret_cast<const char*> (&size), sizeof (size)).append(token);
+                }
+                _scratch.push_back(';');
+                return true;
+            });
+            if (!error && !found && fall_back(error)) {
+                found = true;
+                for (std::string_view token : _fallback) {
+                    std::size_t size = token.size();
+                    _scratch.append(reinterpret_cast<const char*> (&size), sizeof (size)).append(token);
+                }
+                _scratch.push_back('=');
+            } else
+                _fallback.clear();
+            if (error) {
+                _arguments.fail(*this, error);
+                return false;
+            }
+
+            if (_fingerprinted && found == _found && _scratch == _fingerprint) return false;
+
+            _fingerprinted = false;
+            _found = found;
+            convert_pending();
+            _fingerprint.swap(_scratch);
+            _fingerprinted = true;
+            return true;
+        }
+
+        void forget() override {
+            _fingerprinted = false;
+        }
+
+        void save(std::string & blob) const override {
+            const BaseType & value = val();
+            serializer<bool>::write(blob, _found);
+            serializer<BaseType>::write(blob, value);
+        }
+
+        bool load(const char* & p, const char* end) override {
+            _fingerprinted = false;
+            _pending = false;
+            _fallback.clear();
+            return serializer<bool>::read(p, end, _found) && serializer<BaseType>::read(p, end, _var);
+        }
+
+        std::string saved_type() const override {
+            return saved_type_name<BaseType>::get();
         }
 
         const BaseType & operator *() const {
-            return _var;
+            return val();
         }
 
+        //! the value. after a lazy match the first call converts it, which is not thread safe:
+        //! share the arguments between threads only after every value was read once (the
+        //! results of cmdl::parser are converted eagerly)
+
         const BaseType & val() const {
+            if (_pending) convert_pending();
             return _var;
         }
 
@@ -229,96 +2517,98 @@ namespace cmdl {
 
     template<typename Type>
     class posarg : public basetypearg<Type> {
-    public:
-
-        posarg(arguments & args, const std::string & help_instruction, Type initial_value) :
-        basetypearg<Type>(args, "", "", help_instruction, "posarg", 1) {
+    protected:
+        Type _initial_value;
 
-            this->_var = initial_value;
-            this->_found = false;
+        void reset() const override {
+            this->_var = _initial_value;
+        }
 
-            for (std::list<std::string>::iterator it = this->_command_line_args.begin(); it != this->_command_line_args.end(); it++)
-                if (*it != "--") {
-                    std::istringstream is(*it);
-                    if (!(is >> this->_var))
-                        throw std::runtime_error("Wrong command line arguments. Try --help!");
-                    it = this->_command_line_args.erase(it);
-                    this->_found = true;
-                    break;
-                } else break;
+        bool assign(const std::string_view * values) const override {
+            return convert(values[0], this->_var);
         }
-    };
 
-    template<typename Type>
-    class multiposarg : public basetypearg<std::vector<Type > > {
     public:
 
-        multiposarg(arguments & args, const std::string & help_instruction, Type initial_value, const int length = 0) :
-        basetypearg < std::vector < Type > > (args, "", "", help_instruction, "multiposarg", length) {
+        posarg(arguments & args, std::string_view help_instruction, Type initial_value) :
+        basetypearg<Type>(args, "", "", help_instruction, "posarg", 1, false, true), _initial_value(make_value<Type>(args.resource(), std::move(initial_value))) {
+            this->parse();
+        }
+    };
 
-            std::string str;
-            std::stringstream ss;
-            ss << length;
-            ss >> str;
+    template<typename Type, typename Allocator = std::allocator<Type> >
+    class multiposarg : public basetypearg<std::vector<Type, Allocator > > {
+    protected:
+        Type _initial_value;
 
+        void reset() const override {
             this->_var.clear();
-            this->_found = false;
-
-            for (std::list<std::string>::iterator it = this->_command_line_args.begin(); it != this->_command_line_args.end(); it++)
-                if (*it != "--") {
-
-                    std::istringstream is(*it);
-
-                    Type tmp;
-
-                    if (!(is >> tmp))
-                        throw std::runtime_error("Wrong command line arguments. Try --help!");
+        }
 
-                    it = this->_command_line_args.erase(it);
-                    --it;
+        bool assign(const std::string_view * values) const override {
+            Type tmp = make_value<Type>(this->_arguments.resource());
 
-                    this->_var.push_back(tmp);
+            if (!convert(values[0], tmp))
+                return false;
 
-                    this->_found = true;
+            this->_var.push_back(std::move(tmp));
+            return true;
+        }
 
-                    if (length > 0 && this->_var.size() >= length) break;
+        void finish() const override {
+            if (!this->_found) this->_var.push_back(make_value<Type>(this->_arguments.resource(), _initial_value));
+        }
 
-                } else break;
+    public:
 
-            if (!this->_found) this->_var.push_back(initial_value);
+        multiposarg(arguments & args, std::string_view help_instruction, Type initial_value, const int length = 0) :
+        basetypearg < std::vector < Type, Allocator > > (args, "", "", help_instruction, "multiposarg", length, true, true), _initial_value(make_value<Type>(args.resource(), std::move(initial_value))) {
+            this->parse();
         }
-    
+
 	};
 
     template<bool default_value>
     class switcharg : public basetypearg<bool> {
-    public:
-
-        switcharg(arguments & args, const std::string & short_name, const std::string & long_name, const std::string & help_instruction) :
-        basetypearg<bool>(args, short_name, long_name, help_instruction, "switcharg", 0) {
+    protected:
 
+        void reset() const override {
             this->_var = default_value;
-            this->_found = false;
+        }
 
-            for (std::list<std::string>::iterator it = this->_command_line_args.begin(); it != this->_command_line_args.end(); it++)
-                if (*it != "--") {
-                    if ((*it == short_name) || (*it == long_name)) {
+        bool assign(const std::string_view *) const override {
+            return true;
+        }
 
-                        if (this->_found)
-                            throw std::runtime_error("Multiple " + *it + " command line arguments. Try --help!");
+        //! the command line switches the default, an environment or config value sets the value
 
-                        it = this->_command_line_args.erase(it);
+        void finish() const override {
+            bool value;
+            if (!this->_fallback.empty() && switch_value(this->_fallback.back(), value)) this->_var = value;
+            else if (this->_found) this->_var = !default_value;
+        }
 
-                        this->_var = !_var;
-                        this->_found = true;
+    public:
 
-                    }
-                } else break;
+        switcharg(arguments & args, std::string_view short_name, std::string_view long_name, std::string_view help_instruction) :
+        basetypearg<bool>(args, short_name, long_name, help_instruction, "switcharg", 0) {
+            this->parse();
         }
     };
 
     template<typename Type>
     class vararg : public basetypearg<Type> {
+    protected:
+        Type _initial_value;
+
+        void reset() const override {
+            this->_var = _initial_value;
+        }
+
+        bool assign(const std::string_view * values) const override {
+            return convert(values[0], this->_var);
+        }
+
     public:
         //! constructor
         //! @param args arguments type that contains the command line input
@@ -327,165 +2617,366 @@ namespace cmdl {
         //! @param help simple help message for this input
         //! @param def default value of this input
 
-        vararg(arguments & args, const std::string & short_name, const std::string & long_name, const std::string & help_instruction, Type initial_value) :
-        basetypearg<Type>(args, short_name, long_name, help_instruction, "vararg", 1) {
+        vararg(arguments & args, std::string_view short_name, std::string_view long_name, std::string_view help_instruction, Type initial_value) :
+        basetypearg<Type>(args, short_name, long_name, help_instruction, "vararg", 1), _initial_value(make_value<Type>(args.resource(), std::move(initial_value))) {
+            this->parse();
+        }
+    };
+
+    template<typename FirstType, typename... Types>
+    class tuplevararg : public basetypearg<std::tuple<FirstType, Types... > > {
+    protected:
+        std::tuple<FirstType, Types...> _initial_value;
+
+        void reset() const override {
+            this->_var = _initial_value;
+        }
 
-            this->_var = initial_value;
-            this->_found = false;
+        bool assign(const std::string_view * values) const override {
+            return convert_tuple(values, this->_var, std::index_sequence_for<FirstType, Types...>());
+        }
 
-            for (std::list<std::string>::iterator it = this->_command_line_args.begin(); it != this->_command_line_args.end(); it++)
-                if (*it != "--") {
-                    if ((*it == short_name) || (*it == long_name)) {
+    public:
 
-                        if (this->_found)
-                            throw std::runtime_error("Multiple " + *it + " command line arguments. Try --help!");
+        tuplevararg(arguments & args, std::string_view short_name, std::string_view long_name, std::string_view help_instruction, FirstType firstvalue, Types... values) :
+        basetypearg < std::tuple<FirstType, Types... > > (args, short_name, long_name, help_instruction, "tuplevararg", std::tuple_size < std::tuple < FirstType, Types... > >::value),
+        _initial_value(make_value<std::tuple<FirstType, Types...> >(args.resource(), std::tuple<FirstType, Types...>(std::move(firstvalue), std::move(values)...))) {
+            this->parse();
+        }
+    };
 
-                        if (*++it == "--")
-                            throw std::runtime_error("Wrong command line arguments. Try --help!");
+    template<typename Type, typename Allocator = std::allocator<Type> >
+    class multivararg : public basetypearg<std::vector<Type, Allocator > > {
+    protected:
+        Type _initial_value;
 
-                        std::istringstream is(*it);
-                        if (!(is >> this->_var))
-                            throw std::runtime_error("Wrong command line arguments. Try --help!");
+        void reset() const override {
+            this->_var.clear();
+        }
 
-                        it = this->_command_line_args.erase(it);
-                        it = this->_command_line_args.erase(--it);
+        bool assign(const std::string_view * values) const override {
+            Type tmp = make_value<Type>(this->_arguments.resource());
 
-                        this->_found = true;
+            if (!convert(values[0], tmp))
+                return false;
 
-                    }
-                } else break;
+            this->_var.push_back(std::move(tmp));
+            return true;
+        }
 
+        void finish() const override {
+            if (!this->_found) this->_var.push_back(make_value<Type>(this->_arguments.resource(), _initial_value));
         }
-    };
 
-    template<typename FirstType, typename... Types>
-    class tuplevararg : public basetypearg<std::tuple<FirstType, Types... > > {
     public:
 
-        tuplevararg(arguments & args, const std::string & short_name, const std::string & long_name, const std::string & help_instruction, FirstType firstvalue, Types... values) :
-        basetypearg < std::tuple<FirstType, Types... > > (args, short_name, long_name, help_instruction, "tuplevararg", std::tuple_size < std::tuple < FirstType, Types... > >::value) {
+        multivararg(arguments & args, std::string_view short_name, std::string_view long_name, std::string_view help_instruction, Type initial_value) :
+        basetypearg < std::vector < Type, Allocator > > (args, short_name, long_name, help_instruction, "multivararg", 1, true), _initial_value(make_value<Type>(args.resource(), std::move(initial_value))) {
+            this->parse();
+        }
 
-            this->_var = std::tuple<FirstType, Types...>(firstvalue, values...);
-            this->_found = false;
+    };
 
-            for (std::list<std::string>::iterator it = this->_command_line_args.begin(); it != this->_command_line_args.end(); it++)
-                if (*it != "--") {
-                    if ((*it == short_name) || (*it == long_name)) {
+    //! muplevararg with the allocator of its vector, which cannot follow the element types as
+    //! a default template parameter
 
-                        if (this->_found)
-                            throw std::runtime_error("Multiple " + *it + " command line arguments. Try --help!");
+    template<typename Allocator, typename FirstType, typename... Types>
+    class basic_muplevararg : public basetypearg<std::vector<std::tuple<FirstType, Types... >, Allocator > > {
+    protected:
+        std::tuple<FirstType, Types...> _initial_value;
 
-                        std::stringstream ios;
+        void reset() const override {
+            this->_var.clear();
+        }
 
-                        for (int i = 0; i < std::tuple_size < std::tuple < FirstType, Types... > >::value; i++) {
-                            if (*++it == "--")
-                                throw std::runtime_error("Wrong command line arguments. Try --help!");
-                            ios << *it << ' ';
-                        }
+        bool assign(const std::string_view * values) const override {
+            std::tuple<FirstType, Types...> tmp = make_value<std::tuple<FirstType, Types...> >(this->_arguments.resource());
 
-                        if (!obtain(ios, firstvalue, values...))
-                            throw std::runtime_error("Wrong command line arguments. Try --help!");
+            if (!convert_tuple(values, tmp, std::index_sequence_for<FirstType, Types...>()))
+                return false;
 
-                        this->_var = std::tuple<FirstType, Types...>(firstvalue, values...);
+            this->_var.push_back(std::move(tmp));
+            return true;
+        }
 
-                        for (int i = 0; i < std::tuple_size < std::tuple < FirstType, Types... > >::value; i++) {
-                            it = this->_command_line_args.erase(it);
-                            --it;
-                        }
+        void finish() const override {
+            if (!this->_found) this->_var.push_back(make_value<std::tuple<FirstType, Types...> >(this->_arguments.resource(), _initial_value));
+        }
 
-                        it = this->_command_line_args.erase(it);
-                        this->_found = true;
+    public:
 
-                    }
-                } else break;
+        basic_muplevararg(arguments & args, std::string_view short_name, std::string_view long_name, std::string_view help_instruction, FirstType firstvalue, Types... values) :
+        basetypearg < std::vector < std::tuple<FirstType, Types... >, Allocator > >(args, short_name, long_name, help_instruction, "muplevararg", std::tuple_size < std::tuple < FirstType, Types... > >::value, true),
+        _initial_value(make_value<std::tuple<FirstType, Types...> >(args.resource(), std::tuple<FirstType, Types...>(std::move(firstvalue), std::move(values)...))) {
+            this->parse();
         }
+
     };
 
-    template<typename Type>
-    class multivararg : public basetypearg<std::vector<Type > > {
+    template<typename FirstType, typename... Types>
+    class muplevararg : public basic_muplevararg<std::allocator<std::tuple<FirstType, Types...> >, FirstType, Types...> {
     public:
+        using basic_muplevararg<std::allocator<std::tuple<FirstType, Types...> >, FirstType, Types...>::basic_muplevararg;
+    };
 
-        multivararg(arguments & args, const std::string & short_name, const std::string & long_name, const std::string & help_instruction, Type initial_value) :
-        basetypearg < std::vector < Type > > (args, short_name, long_name, help_instruction, "multivararg", 1) {
+    template<typename Type, typename Allocator = std::allocator<Type> >
+    class listvararg : public basetypearg<std::vector<Type, Allocator > > {
+    protected:
+        Type _initial_value;
 
+        void reset() const override {
             this->_var.clear();
-            this->_found = false;
+        }
 
-            for (std::list<std::string>::iterator it = this->_command_line_args.begin(); it != this->_command_line_args.end(); it++)
-                if (*it != "--") {
-                    if ((*it == short_name) || (*it == long_name)) {
-                        if (*++it == "--")
-                            throw std::runtime_error("Wrong command line arguments. Try --help!");
+        static constexpr bool integer = std::is_integral<Type>::value && !std::is_same<Type, bool>::value && sizeof (Type) != sizeof (char);
 
-                        std::istringstream is(*it);
-                        Type tmp;
+        bool check(const std::string_view * values) const override {
+            return list_splitter::split(values[0], integer, [this](const char* begin, const char* end) {
+                Type tmp = make_value<Type>(this->_arguments.resource());
+                return cmdl::check(std::string_view(begin, end - begin), tmp);
+            });
+        }
 
-                        if (!(is >> tmp))
-                            throw std::runtime_error("Wrong command line arguments. Try --help!");
+        bool assign(const std::string_view * values) const override {
+            std::string_view token = values[0];
+
+            this->_var.reserve(list_splitter::count(token));
+            return list_splitter::split(token, integer, [this](const char* begin, const char* end) {
+                this->_var.push_back(make_value<Type>(this->_arguments.resource()));
+                return convert(std::string_view(begin, end - begin), this->_var.back());
+            });
+        }
+
+        void finish() const override {
+            if (!this->_found) this->_var.push_back(make_value<Type>(this->_arguments.resource(), _initial_value));
+        }
 
-                        this->_var.push_back(tmp);
+    public:
+        //! constructor
+        //! the whole list is one token, e.g. --ids 1,2,3 or --xs "0.1 0.2 0.3"
+        //! @param args arguments type that contains the command line input
+        //! @param short_name short version of the switch
+        //! @param long_name long version of the switch
+        //! @param help_instruction simple help message for this input
+        //! @param initial_value the only item when the switch is not given
+
+        listvararg(arguments & args, std::string_view short_name, std::string_view long_name, std::string_view help_instruction, Type initial_value) :
+        basetypearg < std::vector < Type, Allocator > > (args, short_name, long_name, help_instruction, "listvararg", 1), _initial_value(make_value<Type>(args.resource(), std::move(initial_value))) {
+            this->parse();
+        }
+
+    };
+
+    //!
+    //!  stream range class
+    //!  the value of a streamposarg: a single pass input range over the free tokens in front
+    //!  of the "--" cutoff, followed by the lines of an optional continuation stream. every
+    //!  item is converted and consumed when it is pulled, none is stored.
+    //!
+
+    template<typename Type>
+    class stream_range {
+    protected:
+        token_table * _tokens;
+        std::istream * _continuation;
 
-                        it = this->_command_line_args.erase(it);
-                        it = this->_command_line_args.erase(--it);
-                        it--;
+    public:
 
-                        this->_found = true;
+        class iterator {
+        protected:
+            token_table * _tokens;
+            std::istream * _continuation;
+            Type _value;
+            bool _done;
+
+            void pull() {
+                if (_tokens) {
+                    std::size_t it = _tokens->live(0);
+                    if (!_tokens->is_terminator(it)) {
+                        if (!convert((*_tokens)[it], _value))
+                            throw std::runtime_error("Wrong command line arguments. Try --help!");
+                        _tokens->consume(it);
+                        return;
                     }
-                } else break;
+                    _tokens = nullptr;
+                }
+
+                std::string line;
+                while (_continuation && std::getline(*_continuation, line)) {
+                    if (!line.empty() && line.back() == '\r') line.pop_back();
+                    if (line.empty()) continue;
+                    if (!convert(line, _value))
+                        throw std::runtime_error("Wrong command line arguments. Try --help!");
+                    return;
+                }
+                _done = true;
+            }
+
+        public:
+            typedef std::input_iterator_tag iterator_category;
+            typedef Type value_type;
+            typedef std::ptrdiff_t difference_type;
+            typedef const Type * pointer;
+            typedef const Type & reference;
+
+            iterator() : _tokens(nullptr), _continuation(nullptr), _value(), _done(true) {
+            }
+
+            iterator(token_table * tokens, std::istream * continuation) : _tokens(tokens), _continuation(continuation), _value(), _done(false) {
+                pull();
+            }
+
+            const Type & operator*() const {
+                return _value;
+            }
+
+            const Type * operator->() const {
+                return &_value;
+            }
+
+            iterator & operator++() {
+                pull();
+                return *this;
+            }
+
+            void operator++(int) {
+                pull();
+            }
 
-            if (!this->_found) this->_var.push_back(initial_value);
+            bool operator==(const iterator & other) const {
+                return _done && other._done;
+            }
+
+            bool operator!=(const iterator & other) const {
+                return !(*this == other);
+            }
+        };
+
+        stream_range() : _tokens(nullptr), _continuation(nullptr) {
+        }
+
+        stream_range(token_table & tokens, std::istream * continuation) : _tokens(&tokens), _continuation(continuation) {
+        }
+
+        //! the items not pulled yet, a second begin continues where the first stopped
 
+        iterator begin() const {
+            return iterator(_tokens, _continuation);
         }
 
+        iterator end() const {
+            return iterator();
+        }
     };
 
-    template<typename FirstType, typename... Types>
-    class muplevararg : public basetypearg<std::vector<std::tuple<FirstType, Types... > > > {
-    public:
+    template<typename Type>
+    struct type_name<stream_range<Type> > {
 
-        muplevararg(arguments & args, const std::string & short_name, const std::string & long_name, const std::string & help_instruction, FirstType firstvalue, Types... values) :
-        basetypearg < std::vector < std::tuple<FirstType, Types... > > >(args, short_name, long_name, help_instruction, "muplevararg", std::tuple_size < std::tuple < FirstType, Types... > >::value) {
+        static constexpr std::string_view get() {
+            return type_name<Type>::get();
+        }
+    };
 
-            this->_var.clear();
-            this->_found = false;
+    template<typename Type>
+    struct saved_type_name<stream_range<Type> > {
 
-            for (std::list<std::string>::iterator it = this->_command_line_args.begin(); it != this->_command_line_args.end(); it++)
-                if (*it != "--") {
-                    if ((*it == short_name) || (*it == long_name)) {
+        static std::string get() {
+            return saved_type_name<Type>::get();
+        }
+    };
 
-                        std::stringstream ios;
+    template<typename Type>
+    struct value_element<stream_range<Type> > {
+        typedef Type type;
+    };
 
-                        for (int i = 0; i < std::tuple_size < std::tuple < FirstType, Types... > >::value; i++) {
-                            if (*++it == "--")
-                                throw std::runtime_error("Wrong command line arguments. Try --help!");
-                            ios << *it << ' ';
-                        }
+    //! a stream range refers to the token table and a stream, it has no value to save
 
-                        if (!obtain(ios, firstvalue, values...))
-                            throw std::runtime_error("Wrong command line arguments. Try --help!");
+    template<typename Type>
+    struct serializer<stream_range<Type> > {
+        static const bool supported = false;
 
-                        auto tmp = std::tuple<FirstType, Types...>(firstvalue, values...);
+        static void write(std::string &, const stream_range<Type> &) {
+            throw std::runtime_error("Cannot save streamposarg values. Try --help!");
+        }
 
-                        this->_var.push_back(tmp);
+        static bool read(const char* &, const char*, stream_range<Type> &) {
+            return false;
+        }
+    };
 
-                        for (int i = 0; i < std::tuple_size < std::tuple < FirstType, Types... > > ::value; i++) {
-                            it = this->_command_line_args.erase(it);
-                            --it;
-                        }
+    template<typename Type>
+    class streamposarg : public basetypearg<stream_range<Type> > {
+    protected:
+        std::istream * _continuation;
 
-                        it = this->_command_line_args.erase(it);
-                        it--;
+        void reset() const override {
+            this->_var = stream_range<Type>(this->_command_line_args, _continuation);
+        }
 
-                        this->_found = true;
+        bool assign(const std::string_view *) const override {
+            return true;
+        }
 
-                    }
-                } else break;
+    public:
+        //! constructor
+        //! takes every free token in front of the "--" cutoff, so it is declared after all
+        //! other arguments. the tokens stay on the command line until they are pulled:
+        //!
+        //!     cmdl::streamposarg<std::string> files(args, "input files", &std::cin);
+        //!     for (const std::string & file : *files) process(file);
+        //!
+        //! @param args arguments type that contains the command line input
+        //! @param help_instruction simple help message for this input
+        //! @param continuation items read line by line after the command line ones, e.g. &std::cin
+        //!        or an std::ifstream of a file list, nullptr for none
+
+        streamposarg(arguments & args, std::string_view help_instruction, std::istream * continuation = nullptr) :
+        basetypearg < stream_range < Type > > (args, "", "", help_instruction, "streamposarg", 0, true, true), _continuation(continuation) {
+            this->parse();
+        }
 
-            if (!this->_found) this->_var.push_back(std::tuple < FirstType, Types...>(firstvalue, values...));
+        void parse() override {
+            this->_fingerprinted = false;
+            this->_pending = false;
+            reset();
+            this->_found = !this->_command_line_args.is_terminator(this->_command_line_args.live(0));
         }
 
+        bool update() override {
+            parse();
+            return true;
+        }
     };
 
+    //!
+    //!  the vector valued arguments with their values drawn from the memory resource of the
+    //!  arguments object, for allocation free parsing:
+    //!
+    //!      char buffer[1 << 16];
+    //!      std::pmr::monotonic_buffer_resource arena(buffer, sizeof (buffer));
+    //!      cmdl::arguments args(argc, argv, &arena);
+    //!      cmdl::pmr::multivararg<int> ids(args, "-i", "--id", "job ids", 0);
+    //!
+
+    namespace pmr {
+
+        template<typename Type>
+        using multiposarg = cmdl::multiposarg<Type, std::pmr::polymorphic_allocator<Type> >;
+
+        template<typename Type>
+        using multivararg = cmdl::multivararg<Type, std::pmr::polymorphic_allocator<Type> >;
+
+        template<typename Type>
+        using listvararg = cmdl::listvararg<Type, std::pmr::polymorphic_allocator<Type> >;
+
+        template<typename FirstType, typename... Types>
+        class muplevararg : public basic_muplevararg<std::pmr::polymorphic_allocator<std::tuple<FirstType, Types...> >, FirstType, Types...> {
+        public:
+            using basic_muplevararg<std::pmr::polymorphic_allocator<std::tuple<FirstType, Types...> >, FirstType, Types...>::basic_muplevararg;
+        };
+    }
+
 }
 #endif // COMMAND_LINE_ARGUMENT_H
 
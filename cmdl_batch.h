@@ -0,0 +1,345 @@
+// ///////////////////////////// MIT License //////////////////////////////////// //
+//                                                                                //
+// Copyright (c) 2013 David Zsolt Manrique                                        //
+//                    david.zsolt.manrique@gmail.com                              //
+//                                                                                //
+// Permission is hereby granted, free of charge, to any person obtaining a copy   //
+// of this software and associated documentation files (the "Software"), to deal  //
+// in the Software without restriction, including without limitation the rights   //
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      //
+// copies of the Software, and to permit persons to whom the Software is          //
+// furnished to do so, subject to the following conditions:                       //
+//                                                                                //
+// The above copyright notice and this permission notice shall be included in     //
+// all copies or substantial portions of the Software.                            //
+//                                                                                //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    //
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  //
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN      //
+// THE SOFTWARE.                                                                  //
+//                                                                                //
+// ////////////////////////////////////////////////////////////////////////////// //
+
+
+
+#ifndef COMMAND_LINE_BATCH_H
+#define COMMAND_LINE_BATCH_H
+
+#include "cmdl_parser.h"
+
+namespace cmdl {
+
+    //!
+    //!  batch class
+    //!  validates a manifest of command lines, one per line, against the option set of a
+    //!  parser. the manifest is memory mapped (or given as text) and cut into chunks at line
+    //!  ends, the chunks are handed out to a pool of threads, and every thread parses all of
+    //!  its lines into one reused parser::result with try_parse, so nothing is declared again
+    //!  and no exception is thrown. blank lines and # comment lines are skipped.
+    //!
+    //!      cmdl::parser p;
+    //!      auto jobs = p.add<cmdl::vararg<int> >("-j", "--jobs", "number of jobs", 1);
+    //!      cmdl::batch::report r = cmdl::batch(p).validate_file("jobs.txt");
+    //!      for (std::size_t i = 0; i < r.size(); i++)
+    //!          if (r.ok(i)) use(r.value(jobs, i));
+    //!          else std::cerr << r.line(i) << ": " << r.message(i) << '\n';
+    //!
+
+    class batch {
+    public:
+
+        //!
+        //!  report class
+        //!  the outcome of every command line of a manifest, in manifest order, column by
+        //!  column: line number, error code, position of the offending token and message (empty
+        //!  for valid lines), and one column per declared argument with the saved values of the
+        //!  valid lines (basearg::save: is_set and the value in the serializer format). print
+        //!  writes all of it as tab separated text, print_errors only the invalid lines.
+        //!
+
+        class report {
+            friend class batch;
+        protected:
+            const parser * _parser = nullptr;
+            std::vector<std::string> _names;
+            std::vector<std::size_t> _line;
+            std::vector<unsigned char> _code;
+            std::vector<std::size_t> _token;
+            std::string _messages;
+            std::vector<std::size_t> _message_offsets;
+
+            struct column {
+                std::string data;
+                std::vector<std::size_t> offsets;
+            };
+            std::vector<column> _columns;
+
+            void reset(std::size_t arguments) {
+                _line.clear();
+                _code.clear();
+                _token.clear();
+                _messages.clear();
+                _message_offsets.assign(1, 0);
+                _columns.assign(arguments, column());
+                for (column & c : _columns) c.offsets.assign(1, 0);
+            }
+
+            //! append the rows of a report of a later part of the manifest
+            //! @param lines number of manifest lines in front of that part
+
+            void append(const report & other, std::size_t lines) {
+                for (std::size_t line : other._line) _line.push_back(line + lines);
+                _code.insert(_code.end(), other._code.begin(), other._code.end());
+                _token.insert(_token.end(), other._token.begin(), other._token.end());
+
+                std::size_t base = _messages.size();
+                _messages += other._messages;
+                for (std::size_t i = 1; i < other._message_offsets.size(); i++) _message_offsets.push_back(base + other._message_offsets[i]);
+
+                for (std::size_t c = 0; c < _columns.size(); c++) {
+                    base = _columns[c].data.size();
+                    _columns[c].data += other._columns[c].data;
+                    for (std::size_t i = 1; i < other._columns[c].offsets.size(); i++) _columns[c].offsets.push_back(base + other._columns[c].offsets[i]);
+                }
+            }
+
+            std::string_view cell(std::size_t index, std::size_t row) const {
+                const column & c = _columns[index];
+                return std::string_view(c.data.data() + c.offsets[row], c.offsets[row + 1] - c.offsets[row]);
+            }
+
+        public:
+
+            //! number of command lines
+
+            std::size_t size() const {
+                return _line.size();
+            }
+
+            //! line number in the manifest, from 1
+
+            std::size_t line(std::size_t row) const {
+                return _line[row];
+            }
+
+            bool ok(std::size_t row) const {
+                return _code[row] == parse_error::none;
+            }
+
+            parse_error::error_code code(std::size_t row) const {
+                return parse_error::error_code(_code[row]);
+            }
+
+            //! position of the offending token after the program name, parse_error::npos if none
+
+            std::size_t token(std::size_t row) const {
+                return _token[row];
+            }
+
+            std::string_view message(std::size_t row) const {
+                return std::string_view(_messages.data() + _message_offsets[row], _message_offsets[row + 1] - _message_offsets[row]);
+            }
+
+            //! number of invalid command lines
+
+            std::size_t errors() const {
+                return std::size_t(std::count_if(_code.begin(), _code.end(), [](unsigned char code) {
+                    return code != parse_error::none;
+                }));
+            }
+
+            //! whether the argument is set on a valid command line
+
+            template<typename Arg>
+            bool is_set(parser::handle<Arg> h, std::size_t row) const {
+                std::string_view saved = cell(h._index, row);
+                return !saved.empty() && saved[0] == 1;
+            }
+
+            //! value of the argument on a valid command line, read back from its column. the
+            //! value of an invalid line is the default constructed one.
+
+            template<typename Arg>
+            typename std::decay<decltype(std::declval<const Arg &>().val())>::type value(parser::handle<Arg> h, std::size_t row) const {
+                typedef typename std::decay<decltype(std::declval<const Arg &>().val())>::type value_type;
+                value_type value = make_value<value_type>(std::pmr::get_default_resource());
+                std::string_view saved = cell(h._index, row);
+                if (saved.empty()) return value;
+                const char* p = saved.data() + 1;
+                if (!serializer<value_type>::read(p, saved.data() + saved.size(), value))
+                    throw std::runtime_error("Wrong saved arguments. Try --help!");
+                return value;
+            }
+
+            //! every line as one row of tab separated columns, under a header row: line number,
+            //! error code (0 for a valid line), token position (- if none), message, and one
+            //! column per argument, named by its long or short name without dashes, arg-1, arg-2,
+            //! ... for the positionals. the values of valid lines are written as by value_text,
+            //! the value columns of invalid lines are empty.
+            //! @param os stream
+
+            void print(std::ostream & os) const {
+                std::string text = "line\tcode\ttoken\tmessage";
+                for (const std::string & name : _names) text.append(1, '\t').append(name);
+                text.push_back('\n');
+                for (std::size_t row = 0; row < size(); row++) {
+                    text.append(std::to_string(_line[row])).append(1, '\t').append(std::to_string(_code[row])).push_back('\t');
+                    text.append(_token[row] == parse_error::npos ? std::string("-") : std::to_string(_token[row])).push_back('\t');
+                    value_text<std::string_view>::escape(text, message(row));
+                    for (std::size_t c = 0; c < _columns.size(); c++) {
+                        text.push_back('\t');
+                        if (ok(row)) _parser->_declarations[c]->append_text(text, cell(c, row));
+                    }
+                    text.push_back('\n');
+                    if (text.size() > (1 << 16)) {
+                        os.write(text.data(), std::streamsize(text.size()));
+                        text.clear();
+                    }
+                }
+                os.write(text.data(), std::streamsize(text.size()));
+            }
+
+            //! the invalid lines, one per line: line number, token position and message, tab
+            //! separated
+            //! @param os stream
+
+            void print_errors(std::ostream & os) const {
+                std::string text;
+                for (std::size_t row = 0; row < size(); row++)
+                    if (!ok(row)) {
+                        text.append(std::to_string(_line[row])).push_back('\t');
+                        text.append(_token[row] == parse_error::npos ? std::string("-") : std::to_string(_token[row])).push_back('\t');
+                        text.append(message(row)).push_back('\n');
+                    }
+                os.write(text.data(), std::streamsize(text.size()));
+            }
+        };
+
+    protected:
+        const parser & _parser;
+        std::vector<std::string> _names;
+
+        //! validate the lines of one chunk
+        //! @param text the chunk, whole lines
+        //! @param r reused parse state of the thread
+        //! @param out empty report of the chunk, with line numbers counted from the chunk
+        //! @return number of lines of the chunk
+
+        std::size_t validate_chunk(std::string_view text, parser::result & r, report & out) const {
+            std::size_t lines = 0;
+            while (!text.empty()) {
+                std::size_t end = text.find('\n');
+                std::string_view line = text.substr(0, end);
+                text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+                lines++;
+
+                std::size_t first = 0;
+                while (first < line.size() && std::isspace(static_cast<unsigned char> (line[first]))) first++;
+                if (first == line.size() || line[first] == '#') continue;
+                if (line.back() == '\r') line.remove_suffix(1);
+
+                out._line.push_back(lines);
+                try {
+                    parse_result outcome = _parser.try_parse(line, r);
+                    if (outcome)
+                        for (std::size_t c = 0; c < out._columns.size(); c++) r._objects[c]->save(out._columns[c].data);
+                    out._code.push_back(static_cast<unsigned char> (outcome.error().code));
+                    out._token.push_back(outcome.error().token);
+                    if (!outcome) out._messages += outcome.error().message();
+                } catch (const std::exception & e) {
+                    // as parse_all, an exception only fails its own line; the saved values
+                    // of the line are dropped and the parse state is declared again
+                    for (report::column & c : out._columns) c.data.resize(c.offsets.back());
+                    r.clear();
+                    out._code.push_back(parse_error::exception);
+                    out._token.push_back(parse_error::npos);
+                    out._messages += e.what();
+                }
+                out._message_offsets.push_back(out._messages.size());
+                for (report::column & c : out._columns) c.offsets.push_back(c.data.size());
+            }
+            return lines;
+        }
+
+    public:
+
+        //! @param p option set, it has to outlive this object; the values of all of its
+        //! arguments have to be savable (no streamposarg)
+
+        explicit batch(const parser & p) : _parser(p) {
+            if (!p.savable())
+                throw std::runtime_error("Cannot save the argument values of a batch report. Try --help!");
+
+            // the column names of the report, from the arguments of an empty command line
+            parser::result r;
+            p.try_parse(std::string_view(), r);
+            int positionals = 0;
+            for (const basearg* arg : r._objects) {
+                std::string_view name = arg->_long_name.empty() ? std::string_view(arg->_short_name) : std::string_view(arg->_long_name);
+                while (!name.empty() && name.front() == '-') name.remove_prefix(1);
+                _names.push_back(arg->_positional ? "arg-" + std::to_string(++positionals) : std::string(name));
+            }
+        }
+
+        //! validate a manifest
+        //! @param manifest command lines separated by new lines
+        //! @param threads number of threads, 0 for the hardware concurrency
+
+        report validate(std::string_view manifest, unsigned threads = 0) const {
+            if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+            // chunks of about 256 kB cut at line ends, several per thread to balance the load
+            std::vector<std::string_view> chunks;
+            const std::size_t target = std::max<std::size_t>(1 << 18, manifest.size() / (std::size_t(threads) * 64) + 1);
+            for (std::string_view rest = manifest; !rest.empty();) {
+                std::size_t end = rest.size() <= target ? std::string_view::npos : rest.find('\n', target);
+                end = end == std::string_view::npos ? rest.size() : end + 1;
+                chunks.push_back(rest.substr(0, end));
+                rest.remove_prefix(end);
+            }
+            threads = unsigned(std::min<std::size_t>(threads, std::max<std::size_t>(chunks.size(), 1)));
+
+            std::vector<report> reports(chunks.size());
+            std::vector<std::size_t> lines(chunks.size());
+            std::atomic<std::size_t> next(0);
+            auto work = [&]() {
+                parser::result r;
+                for (std::size_t i; (i = next.fetch_add(1)) < chunks.size();) {
+                    reports[i].reset(_parser.size());
+                    lines[i] = validate_chunk(chunks[i], r, reports[i]);
+                }
+            };
+
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < threads; t++) pool.emplace_back(work);
+            work();
+            for (std::thread & t : pool) t.join();
+
+            report all;
+            all.reset(_parser.size());
+            all._parser = &_parser;
+            all._names = _names;
+            std::size_t before = 0;
+            for (std::size_t i = 0; i < chunks.size(); i++) {
+                all.append(reports[i], before);
+                before += lines[i];
+            }
+            return all;
+        }
+
+        //! validate a manifest file, memory mapped
+        //! @param path file name
+        //! @param threads number of threads, 0 for the hardware concurrency
+
+        report validate_file(const std::string & path, unsigned threads = 0) const {
+            mapped_file file;
+            if (!file.open(path))
+                throw std::runtime_error("Cannot read " + path + " manifest. Try --help!");
+            return validate(std::string_view(file.data(), file.size()), threads);
+        }
+    };
+}
+#endif // COMMAND_LINE_BATCH_H
@@ -0,0 +1,275 @@
+// ///////////////////////////// MIT License //////////////////////////////////// //
+//                                                                                //
+// Copyright (c) 2013 David Zsolt Manrique                                        //
+//                    david.zsolt.manrique@gmail.com                              //
+//                                                                                //
+// Permission is hereby granted, free of charge, to any person obtaining a copy   //
+// of this software and associated documentation files (the "Software"), to deal  //
+// in the Software without restriction, including without limitation the rights   //
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      //
+// copies of the Software, and to permit persons to whom the Software is          //
+// furnished to do so, subject to the following conditions:                       //
+//                                                                                //
+// The above copyright notice and this permission notice shall be included in     //
+// all copies or substantial portions of the Software.                            //
+//                                                                                //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    //
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  //
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN      //
+// THE SOFTWARE.                                                                  //
+//                                                                                //
+// ////////////////////////////////////////////////////////////////////////////// //
+
+
+#ifndef COMMAND_LINE_COMPLETION_H
+#define COMMAND_LINE_COMPLETION_H
+
+#include "cmdl.h"
+
+namespace cmdl {
+
+    //!
+    //!  completer class
+    //!  answers what can come next on a partial command line, from the declared arguments of
+    //!  an arguments object. the option names are kept in one sorted array, so a prefix is
+    //!  a binary search, and the partial command line is walked once to find the option
+    //!  value or positional slot under the cursor.
+    //!
+    //!      cmdl::completer c(args);
+    //!      for (const cmdl::completer::candidate & x : c.complete("program --ve", 12))
+    //!          std::cout << x.text << std::endl;
+    //!
+
+    class completer {
+    public:
+
+        struct candidate {
+            enum candidate_kind { option, value, positional };
+
+            candidate_kind kind;
+            std::string_view text;  //!< option name, empty for values
+            std::string_view type;  //!< value type, e.g. int or string
+            std::string_view help;
+        };
+
+    protected:
+
+        struct entry {
+            std::string kind;
+            std::string short_name;
+            std::string long_name;
+            std::size_t arity;
+            std::vector<std::string> types;
+            std::string help;
+            bool repeatable;
+        };
+
+        std::string _program;
+        std::vector<entry> _entries;
+        std::vector<std::size_t> _positionals;
+
+        // option names, sorted, with the entry they belong to
+        std::vector<std::pair<std::string_view, std::size_t> > _names;
+
+        static std::vector<std::string> split(std::string_view text, char separator) {
+            std::vector<std::string> fields;
+            for (std::size_t begin = 0;;) {
+                std::size_t end = text.find(separator, begin);
+                fields.emplace_back(text.substr(begin, end == std::string_view::npos ? std::string_view::npos : end - begin));
+                if (end == std::string_view::npos) return fields;
+                begin = end + 1;
+            }
+        }
+
+        const entry * find(std::string_view name) const {
+            auto it = std::lower_bound(_names.begin(), _names.end(), name, [](const std::pair<std::string_view, std::size_t> & a, std::string_view b) {
+                return a.first < b;
+            });
+            return it != _names.end() && it->first == name ? &_entries[it->second] : nullptr;
+        }
+
+    public:
+
+        //! constructor
+        //! @param args arguments with the declared arguments, their names, value types and help
+        //!        are copied
+
+        explicit completer(const arguments & args) : _program(args.name()) {
+            for (const basearg* arg : args._defined_args) {
+                entry e;
+                e.kind = arg->_arg_type;
+                e.short_name = arg->_short_name;
+                e.long_name = arg->_long_name;
+                // positionals complete by their maximum count, 0 for any
+                e.arity = arg->_positional ? std::size_t(std::max(arg->_input_number, 0)) : arg->_arity;
+                if (arg->_arity > 0) e.types = split(arg->_value_type, ',');
+                e.help = arg->_help_instruction;
+                e.repeatable = arg->_repeatable;
+                _entries.push_back(std::move(e));
+            }
+
+            for (std::size_t i = 0; i < _entries.size(); i++) {
+                const entry & e = _entries[i];
+                if (e.short_name.empty() && e.long_name.empty()) _positionals.push_back(i);
+                else {
+                    _names.emplace_back(e.short_name, i);
+                    if (e.long_name != e.short_name) _names.emplace_back(e.long_name, i);
+                }
+            }
+            std::sort(_names.begin(), _names.end());
+        }
+
+        completer(const completer &) = delete;
+        completer & operator=(const completer &) = delete;
+
+        //! candidates for the word under the cursor: option names starting with the word,
+        //! the value an option still expects, or the positional slot that is next
+        //! @param cmdline partial command line, starting with the program name
+        //! @param cursor position of the cursor in cmdline
+
+        std::vector<candidate> complete(std::string_view cmdline, std::size_t cursor) const {
+            cmdline = cmdline.substr(0, cursor);
+
+            std::vector<std::string_view> words;
+            for (std::size_t i = 0, n = cmdline.size(); i < n;) {
+                while (i < n && std::isspace(static_cast<unsigned char> (cmdline[i]))) i++;
+                std::size_t begin = i;
+                while (i < n && !std::isspace(static_cast<unsigned char> (cmdline[i]))) i++;
+                if (i > begin) words.push_back(cmdline.substr(begin, i - begin));
+            }
+            std::string_view current;
+            if (!cmdline.empty() && !std::isspace(static_cast<unsigned char> (cmdline.back())) && !words.empty()) {
+                current = words.back();
+                words.pop_back();
+            }
+
+            // walk the finished words: values still owed to an option, positionals taken
+            std::vector<unsigned char> used(_entries.size(), 0);
+            const entry * pending = nullptr;
+            std::size_t owed = 0, taken = 0;
+            bool terminated = false;
+            for (std::size_t w = 1; w < words.size(); w++) {
+                if (owed > 0) {
+                    owed--;
+                    continue;
+                }
+                if (!terminated && words[w] == "--") {
+                    terminated = true;
+                    continue;
+                }
+                const entry * e = terminated ? nullptr : find(words[w]);
+                if (e) {
+                    used[std::size_t(e - _entries.data())] = 1;
+                    pending = e;
+                    owed = e->arity;
+                } else taken++;
+            }
+
+            std::vector<candidate> candidates;
+            if (owed > 0) {
+                std::size_t k = pending->arity - owed;
+                candidates.push_back({candidate::value, std::string_view(), k < pending->types.size() ? std::string_view(pending->types[k]) : std::string_view(), pending->help});
+                return candidates;
+            }
+
+            if (!terminated && (current.empty() || current[0] == '-')) {
+                auto it = std::lower_bound(_names.begin(), _names.end(), current, [](const std::pair<std::string_view, std::size_t> & a, std::string_view b) {
+                    return a.first < b;
+                });
+                for (; it != _names.end() && it->first.substr(0, current.size()) == current; ++it) {
+                    const entry & e = _entries[it->second];
+                    if (used[it->second] && !e.repeatable) continue;
+                    candidates.push_back({candidate::option, it->first, e.types.empty() ? std::string_view() : std::string_view(e.types.front()), e.help});
+                }
+                if (!current.empty()) return candidates;
+            }
+
+            for (std::size_t i : _positionals) {
+                const entry & e = _entries[i];
+                if (e.arity == 0 || taken < e.arity) {
+                    candidates.push_back({candidate::positional, std::string_view(), e.types.empty() ? std::string_view() : std::string_view(e.types.front()), e.help});
+                    break;
+                }
+                taken -= e.arity;
+            }
+            return candidates;
+        }
+
+        //! bash completion script: option names after a dash, nothing (default completion)
+        //! for option values and positionals
+        //! @param os stream
+
+        void print_bash(std::ostream & os) const {
+            std::string program = _program.substr(_program.find_last_of('/') + 1);
+            std::string function = "_cmdl_" + program;
+            for (char & c : function)
+                if (!std::isalnum(static_cast<unsigned char> (c))) c = '_';
+
+            std::string names, valued;
+            for (const std::pair<std::string_view, std::size_t> & n : _names) {
+                names.append(names.empty() ? "" : " ").append(n.first);
+                if (_entries[n.second].arity > 0) valued.append(valued.empty() ? "" : "|").append(n.first);
+            }
+
+            os << function << "() {\n";
+            os << "    local cur=\"${COMP_WORDS[COMP_CWORD]}\" prev=\"${COMP_WORDS[COMP_CWORD-1]}\"\n";
+            if (!valued.empty()) os << "    case \"$prev\" in " << valued << ") return 0 ;; esac\n";
+            os << "    if [[ \"$cur\" == -* ]]; then\n";
+            os << "        COMPREPLY=( $(compgen -W \"" << names << "\" -- \"$cur\") )\n";
+            os << "    fi\n";
+            os << "}\n";
+            os << "complete -o default -F " << function << ' ' << program << '\n';
+        }
+
+        //! zsh completion script for _arguments, with help, value types and positionals
+        //! @param os stream
+
+        void print_zsh(std::ostream & os) const {
+            auto quote = [](std::string_view text) {
+                std::string quoted;
+                for (char c : text)
+                    if (c == '\'') quoted += "'\\''";
+                    else {
+                        if (c == '[' || c == ']' || c == ':' || c == '\\') quoted += '\\';
+                        quoted += c;
+                    }
+                return quoted;
+            };
+
+            std::string program = _program.substr(_program.find_last_of('/') + 1);
+            os << "#compdef " << program << "\n_arguments -s";
+            std::size_t slot = 0;
+            for (const entry & e : _entries) {
+                bool positional = e.short_name.empty() && e.long_name.empty();
+
+                // positionals are numbered slots, an unbounded one takes the rest
+                if (positional && slot == std::size_t(-1)) continue;
+
+                std::string values;
+                for (std::size_t k = 0; k < e.arity && !positional; k++)
+                    values += ":" + (k < e.types.size() ? e.types[k] : std::string("value")) + ":";
+                std::string help = quote(e.help);
+
+                os << " \\\n    ";
+                if (positional) {
+                    if (e.arity == 0) {
+                        os << "'*:" << help << ":_default'";
+                        slot = std::size_t(-1);
+                    } else
+                        for (std::size_t k = 0; k < e.arity; k++)
+                            os << (k ? " '" : "'") << ++slot << ':' << help << ":_default'";
+                } else if (e.long_name.empty() || e.long_name == e.short_name)
+                    os << '\'' << (e.repeatable ? "*" : "") << quote(e.short_name) << '[' << help << ']' << values << '\'';
+                else if (e.short_name.empty())
+                    os << '\'' << (e.repeatable ? "*" : "") << quote(e.long_name) << '[' << help << ']' << values << '\'';
+                else
+                    os << '\'' << (e.repeatable ? "*" : "(" + quote(e.short_name) + ' ' + quote(e.long_name) + ")") << "'{" << quote(e.short_name) << ',' << quote(e.long_name) << "}'[" << help << ']' << values << '\'';
+            }
+            os << '\n';
+        }
+    };
+}
+#endif // COMMAND_LINE_COMPLETION_H
@@ -0,0 +1,376 @@
+// ///////////////////////////// MIT License //////////////////////////////////// //
+//                                                                                //
+// Copyright (c) 2013 David Zsolt Manrique                                        //
+//                    david.zsolt.manrique@gmail.com                              //
+//                                                                                //
+// Permission is hereby granted, free of charge, to any person obtaining a copy   //
+// of this software and associated documentation files (the "Software"), to deal  //
+// in the Software without restriction, including without limitation the rights   //
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      //
+// copies of the Software, and to permit persons to whom the Software is          //
+// furnished to do so, subject to the following conditions:                       //
+//                                                                                //
+// The above copyright notice and this permission notice shall be included in     //
+// all copies or substantial portions of the Software.                            //
+//                                                                                //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    //
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  //
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN      //
+// THE SOFTWARE.                                                                  //
+//                                                                                //
+// ////////////////////////////////////////////////////////////////////////////// //
+
+
+#ifndef COMMAND_LINE_PARSER_H
+#define COMMAND_LINE_PARSER_H
+
+#include "cmdl.h"
+
+#include <atomic>
+#include <limits>
+#include <thread>
+
+namespace cmdl {
+
+    //! a value type that can be written with operator<<
+
+    template<typename Type, typename Enable = void>
+    struct has_output : std::false_type {
+    };
+
+    template<typename Type>
+    struct has_output<Type, std::void_t<decltype(std::declval<std::ostream &>() << std::declval<const Type &>())> > : std::true_type {
+    };
+
+    //!
+    //!  value text
+    //!  a parsed value as one cell of a text report: numbers as they are (floating point values
+    //!  with all their digits), strings with tabs, new lines and backslashes escaped as \t, \n
+    //!  and \\, the elements of a vector separated by commas and those of a tuple by spaces.
+    //!  a type without operator<< is written as its type name in angle brackets.
+    //!
+
+    template<typename Type, typename Enable = void>
+    struct value_text {
+
+        static void escape(std::string & text, std::string_view value) {
+            for (char c : value)
+                if (c == '\t') text.append("\\t");
+                else if (c == '\n') text.append("\\n");
+                else if (c == '\\') text.append("\\\\");
+                else text.push_back(c);
+        }
+
+        static void append(std::string & text, const Type & value) {
+            if constexpr (std::is_same<Type, bool>::value)
+                text.push_back(value ? '1' : '0');
+            else if constexpr (std::is_convertible<const Type &, std::string_view>::value)
+                escape(text, value);
+            else if constexpr (has_output<Type>::value) {
+                std::ostringstream os;
+                if constexpr (std::is_floating_point<Type>::value) os.precision(std::numeric_limits<Type>::max_digits10);
+                os << value;
+                escape(text, os.str());
+            } else
+                text.append("<").append(type_name<Type>::get()).append(">");
+        }
+    };
+
+    template<typename Type, typename Allocator>
+    struct value_text<std::vector<Type, Allocator> > {
+
+        static void append(std::string & text, const std::vector<Type, Allocator> & value) {
+            for (std::size_t i = 0; i < value.size(); i++) {
+                if (i) text.push_back(',');
+                value_text<Type>::append(text, value[i]);
+            }
+        }
+    };
+
+    template<typename... Types>
+    struct value_text<std::tuple<Types...> > {
+
+        static void append(std::string & text, const std::tuple<Types...> & value) {
+            std::size_t i = 0;
+            std::apply([&text, &i](const Types &... elements) {
+                ((text.append(i++ ? " " : ""), value_text<Types>::append(text, elements)), ...);
+            }, value);
+        }
+    };
+
+    //!
+    //!  parser class
+    //!  an immutable definition of an option set. the options are declared once with the
+    //!  argument classes of cmdl.h and their constructor parameters, and every parse builds its
+    //!  own arguments and argument objects inside the result, in a memory arena of that result.
+    //!  parse is const and shares no mutable state, so one parser serves any number of threads.
+    //!
+    //!      cmdl::parser p;
+    //!      auto n = p.add<cmdl::vararg<int> >("-n", "--number", "number of jobs", 1);
+    //!      cmdl::parser::result r = p.parse("program -n 4");
+    //!      int jobs = r[n].val();
+    //!
+
+    class parser {
+        friend class batch;
+    public:
+
+        template<typename Arg>
+        class handle {
+            friend class parser;
+            friend class batch;
+            std::size_t _index;
+
+            explicit handle(std::size_t index) : _index(index) {
+            }
+        };
+
+        class result {
+            friend class parser;
+            friend class batch;
+        protected:
+            std::unique_ptr<std::pmr::monotonic_buffer_resource> _arena;
+            arguments * _args;
+            std::vector<basearg*> _objects;
+            std::string _error;
+
+            void clear() {
+                while (!_objects.empty()) {
+                    _objects.back()->~basearg();
+                    _objects.pop_back();
+                }
+                if (_args) _args->~arguments();
+                _args = nullptr;
+                _arena.reset();
+            }
+
+        public:
+
+            result() : _args(nullptr) {
+            }
+
+            result(result && other) noexcept : _arena(std::move(other._arena)), _args(other._args), _objects(std::move(other._objects)), _error(std::move(other._error)) {
+                other._args = nullptr;
+                other._objects.clear();
+            }
+
+            result & operator=(result && other) noexcept {
+                if (this != &other) {
+                    clear();
+                    _arena = std::move(other._arena);
+                    _args = other._args;
+                    _objects = std::move(other._objects);
+                    _error = std::move(other._error);
+                    other._args = nullptr;
+                    other._objects.clear();
+                }
+                return *this;
+            }
+
+            ~result() {
+                clear();
+            }
+
+            //! the argument object of a declaration. the values are converted at the parse, so a
+            //! const result can be read from several threads
+
+            template<typename Arg>
+            const Arg & operator[](handle<Arg> h) const {
+                return static_cast<const Arg &> (*_objects[h._index]);
+            }
+
+            const arguments & args() const {
+                return *_args;
+            }
+
+            //! false if parse_all caught an error for this command line
+
+            bool ok() const {
+                return _error.empty();
+            }
+
+            const std::string & error() const {
+                return _error;
+            }
+        };
+
+    protected:
+
+        struct declaration {
+
+            virtual ~declaration() {
+            }
+
+            virtual basearg * declare(arguments & args, std::pmr::memory_resource * resource) const = 0;
+
+            //! whether basearg::save supports the value type
+
+            virtual bool savable() const = 0;
+
+            //! append a value saved by basearg::save as value_text, nothing if it cannot be read
+            //! @param saved is_set byte and value
+
+            virtual void append_text(std::string & text, std::string_view saved) const = 0;
+        };
+
+        template<typename Arg, typename... Params>
+        struct declaration_of : declaration {
+            std::tuple<Params...> _params;
+
+            explicit declaration_of(Params... params) : _params(std::move(params)...) {
+            }
+
+            basearg * declare(arguments & args, std::pmr::memory_resource * resource) const override {
+                void* p = resource->allocate(sizeof (Arg), alignof (Arg));
+                return std::apply([&](const Params &... params) {
+                    return static_cast<basearg*> (new (p) Arg(args, params...));
+                }, _params);
+            }
+
+            typedef typename std::decay<decltype(std::declval<const Arg &>().val())>::type value_type;
+
+            bool savable() const override {
+                return serializer<value_type>::supported;
+            }
+
+            void append_text(std::string & text, std::string_view saved) const override {
+                if constexpr (serializer<value_type>::supported) {
+                    value_type value = make_value<value_type>(std::pmr::get_default_resource());
+                    const char* p = saved.data() + 1;
+                    if (!saved.empty() && serializer<value_type>::read(p, saved.data() + saved.size(), value))
+                        value_text<value_type>::append(text, value);
+                } else
+                    (void) text, (void) saved;
+            }
+        };
+
+        std::vector<std::unique_ptr<const declaration> > _declarations;
+
+        //! build the arguments and the argument objects of one parse into r
+        //! @param source constructor parameters of the arguments object
+
+        template<typename... Source>
+        void parse_into(result & r, Source... source) const {
+            r.clear();
+            r._error.clear();
+            r._arena.reset(new std::pmr::monotonic_buffer_resource(4096));
+
+            void* p = r._arena->allocate(sizeof (arguments), alignof (arguments));
+            r._args = new (p) arguments(source..., r._arena.get());
+            r._objects.reserve(_declarations.size());
+            for (const std::unique_ptr<const declaration> & d : _declarations)
+                r._objects.push_back(d->declare(*r._args, r._arena.get()));
+        }
+
+    public:
+
+        parser() {
+        }
+
+        parser(const parser &) = delete;
+        parser & operator=(const parser &) = delete;
+
+        //! declare an argument, in the order of the arguments constructors
+        //! @param params constructor parameters of Arg after the arguments object, kept by value
+
+        template<typename Arg, typename... Params>
+        handle<Arg> add(Params... params) {
+            _declarations.emplace_back(new declaration_of<Arg, typename std::decay<Params>::type...>(std::move(params)...));
+            return handle<Arg>(_declarations.size() - 1);
+        }
+
+        //! number of declared arguments
+
+        std::size_t size() const {
+            return _declarations.size();
+        }
+
+        //! whether the values of all declared arguments can be saved with basearg::save
+
+        bool savable() const {
+            return std::all_of(_declarations.begin(), _declarations.end(), [](const std::unique_ptr<const declaration> & d) {
+                return d->savable();
+            });
+        }
+
+        //! parse one command line, errors are thrown as by the argument constructors
+        //! @param cmdline program name and arguments separated by whitespaces
+
+        result parse(std::string_view cmdline) const {
+            result r;
+            parse_into(r, cmdline);
+            return r;
+        }
+
+        //! parse one command line into a result of an earlier parse of this parser, reusing
+        //! its argument objects and memory instead of declaring the arguments again
+        //! @param cmdline program name and arguments separated by whitespaces
+        //! @param r result to overwrite
+
+        void parse(std::string_view cmdline, result & r) const {
+            if (r._args && r._objects.size() == _declarations.size()) {
+                r._error.clear();
+                r._args->parse(cmdline);
+            } else
+                parse_into(r, cmdline);
+        }
+
+        //! parse one command line into a result without throwing, reusing it as above. a new
+        //! result declares its arguments on an empty command line first. on an error the values
+        //! of r are unspecified, the returned error is valid until the next parse into r.
+        //! @param cmdline program name and arguments separated by whitespaces
+        //! @param r result to overwrite
+
+        parse_result try_parse(std::string_view cmdline, result & r) const {
+            if (!r._args || r._objects.size() != _declarations.size()) parse_into(r, std::string_view());
+            r._error.clear();
+            return r._args->try_parse(cmdline);
+        }
+
+        //! @param argc number of command line arguments
+        //! @param argv command line arguments, they have to outlive the result
+
+        result parse(int argc, char** argv) const {
+            result r;
+            parse_into(r, argc, argv);
+            return r;
+        }
+
+        //! parse many command lines on a pool of threads, an error only fails its own result
+        //! @param cmdlines command lines
+        //! @param threads number of threads, 0 for the hardware concurrency
+
+        std::vector<result> parse_all(const std::vector<std::string> & cmdlines, unsigned threads = 0) const {
+            std::vector<result> results(cmdlines.size());
+            if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+            threads = unsigned(std::min<std::size_t>(threads, (cmdlines.size() + 63) / 64));
+
+            // lines are handed out in chunks, the counter is the only shared state
+            std::atomic<std::size_t> next(0);
+            auto work = [&]() {
+                for (;;) {
+                    std::size_t begin = next.fetch_add(64);
+                    if (begin >= cmdlines.size()) return;
+                    std::size_t end = std::min(begin + 64, cmdlines.size());
+                    for (std::size_t i = begin; i < end; i++)
+                        try {
+                            parse_into(results[i], std::string_view(cmdlines[i]));
+                        } catch (const std::exception & e) {
+                            results[i].clear();
+                            results[i]._error = e.what();
+                        }
+                }
+            };
+
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < threads; t++) pool.emplace_back(work);
+            work();
+            for (std::thread & t : pool) t.join();
+            return results;
+        }
+    };
+}
+#endif // COMMAND_LINE_PARSER_H
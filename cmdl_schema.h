@@ -0,0 +1,318 @@
+// ///////////////////////////// MIT License //////////////////////////////////// //
+//                                                                                //
+// Copyright (c) 2013 David Zsolt Manrique                                        //
+//                    david.zsolt.manrique@gmail.com                              //
+//                                                                                //
+// Permission is hereby granted, free of charge, to any person obtaining a copy   //
+// of this software and associated documentation files (the "Software"), to deal  //
+// in the Software without restriction, including without limitation the rights   //
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      //
+// copies of the Software, and to permit persons to whom the Software is          //
+// furnished to do so, subject to the following conditions:                       //
+//                                                                                //
+// The above copyright notice and this permission notice shall be included in     //
+// all copies or substantial portions of the Software.                            //
+//                                                                                //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    //
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  //
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN      //
+// THE SOFTWARE.                                                                  //
+//                                                                                //
+// ////////////////////////////////////////////////////////////////////////////// //
+
+
+#ifndef COMMAND_LINE_SCHEMA_H
+#define COMMAND_LINE_SCHEMA_H
+
+#include "cmdl.h"
+
+#include <array>
+
+namespace cmdl {
+
+    //!
+    //!  option descriptions of a compile-time schema
+    //!  they mirror the argument classes of cmdl.h but only describe the option,
+    //!  the value lives in the result of schema::parse.
+    //!
+
+    namespace spec {
+
+        template<typename Type>
+        using literal_type = typename std::conditional<std::is_same<Type, std::string>::value, std::string_view, Type>::type;
+
+        template<bool default_value>
+        struct switcharg {
+            typedef bool value_type;
+            static constexpr std::size_t arity = 0;
+            static constexpr bool repeatable = false;
+            static constexpr bool positional = false;
+
+            std::string_view short_name;
+            std::string_view long_name;
+            std::string_view help_instruction;
+
+            value_type initial() const {
+                return default_value;
+            }
+        };
+
+        template<typename Type>
+        struct vararg {
+            typedef Type value_type;
+            static constexpr std::size_t arity = 1;
+            static constexpr bool repeatable = false;
+            static constexpr bool positional = false;
+
+            std::string_view short_name;
+            std::string_view long_name;
+            std::string_view help_instruction;
+            literal_type<Type> initial_value;
+
+            value_type initial() const {
+                return value_type(initial_value);
+            }
+        };
+
+        template<typename Type>
+        struct multivararg {
+            typedef std::vector<Type> value_type;
+            static constexpr std::size_t arity = 1;
+            static constexpr bool repeatable = true;
+            static constexpr bool positional = false;
+
+            std::string_view short_name;
+            std::string_view long_name;
+            std::string_view help_instruction;
+            literal_type<Type> initial_value;
+
+            value_type initial() const {
+                return value_type();
+            }
+        };
+
+        template<typename Type>
+        struct posarg {
+            typedef Type value_type;
+            static constexpr std::size_t arity = 1;
+            static constexpr bool repeatable = false;
+            static constexpr bool positional = true;
+
+            std::string_view help_instruction;
+            literal_type<Type> initial_value;
+
+            value_type initial() const {
+                return value_type(initial_value);
+            }
+        };
+    }
+
+    //!
+    //!  compile-time option schema
+    //!  the whole option set is one constexpr object, the option names are sorted and
+    //!  checked for duplicates while compiling, and parse fills a typed result in a single
+    //!  pass over the command line. it consumes its tokens from an ordinary arguments
+    //!  object, so argument classes declared afterwards still see the rest.
+    //!
+    //!      constexpr cmdl::schema options{
+    //!          cmdl::spec::switcharg<false>{"-h", "--help", "print help message"},
+    //!          cmdl::spec::vararg<int>{"-n", "--number", "number of jobs", 1}};
+    //!      auto result = options.parse(args);
+    //!      int n = result.val<options.index("--number")>();
+    //!
+
+    template<typename... Options>
+    class schema {
+    public:
+        static constexpr std::size_t npos = std::size_t(-1);
+        static constexpr std::size_t size = sizeof...(Options);
+
+        class result {
+            friend class schema;
+        protected:
+            std::tuple<typename Options::value_type...> _values;
+            std::array<bool, sizeof...(Options)> _found;
+
+        public:
+
+            template<std::size_t I>
+            const typename std::tuple_element<I, std::tuple<typename Options::value_type...> >::type & val() const {
+                return std::get<I>(_values);
+            }
+
+            template<std::size_t I>
+            bool is_set() const {
+                return _found[I];
+            }
+        };
+
+    protected:
+
+        struct name_entry {
+            std::string_view name;
+            std::size_t option;
+        };
+
+        typedef void (*handler)(token_table &, std::size_t, result &);
+
+        std::tuple<Options...> _options;
+        std::array<name_entry, 2 * sizeof...(Options) > _names;
+
+        template<std::size_t I>
+        using option_type = typename std::tuple_element<I, std::tuple<Options...> >::type;
+
+        template<std::size_t I>
+        constexpr void add_names(std::size_t & n) {
+            if constexpr (!option_type<I>::positional) {
+                _names[n++] = name_entry{std::get<I>(_options).short_name, I};
+                _names[n++] = name_entry{std::get<I>(_options).long_name, I};
+            }
+        }
+
+        template<std::size_t... I>
+        constexpr void build(std::index_sequence<I...>) {
+            std::size_t n = 0;
+            (add_names<I>(n), ...);
+
+            // unused entries keep an empty name and sort in front
+            for (std::size_t i = 1; i < _names.size(); i++)
+                for (std::size_t j = i; j > 0 && _names[j].name < _names[j - 1].name; j--) {
+                    name_entry tmp = _names[j];
+                    _names[j] = _names[j - 1];
+                    _names[j - 1] = tmp;
+                }
+
+            for (std::size_t i = 1; i < _names.size(); i++)
+                if (!_names[i].name.empty() && _names[i].name == _names[i - 1].name)
+                    throw std::logic_error("duplicate option name in schema");
+        }
+
+        //! handle one occurrence of option I at token position i
+
+        template<std::size_t I>
+        static void on_option(token_table & tokens, std::size_t i, result & r) {
+            auto & var = std::get<I>(r._values);
+
+            if (r._found[I] && !option_type<I>::repeatable)
+                throw std::runtime_error("Multiple " + std::string(tokens[i]) + " command line arguments. Try --help!");
+
+            if constexpr (option_type<I>::arity == 0) {
+                var = !var;
+            } else {
+                std::size_t p = tokens.live(i + 1);
+                if (tokens.is_terminator(p))
+                    throw std::runtime_error("Wrong command line arguments. Try --help!");
+
+                if constexpr (option_type<I>::repeatable) {
+                    typename option_type<I>::value_type::value_type tmp;
+                    if (!convert(tokens[p], tmp))
+                        throw std::runtime_error("Wrong command line arguments. Try --help!");
+                    var.push_back(std::move(tmp));
+                } else if (!convert(tokens[p], var))
+                    throw std::runtime_error("Wrong command line arguments. Try --help!");
+
+                tokens.consume(p);
+            }
+            tokens.consume(i);
+            r._found[I] = true;
+        }
+
+        //! positional options take the leftover tokens in declaration order,
+        //! repeated options that were not given get their initial value
+
+        template<std::size_t I>
+        void finish(token_table & tokens, result & r) const {
+            if constexpr (option_type<I>::positional) {
+                std::size_t p = tokens.live(0);
+                if (tokens.is_terminator(p)) return;
+                if (!convert(tokens[p], std::get<I>(r._values)))
+                    throw std::runtime_error("Wrong command line arguments. Try --help!");
+                tokens.consume(p);
+                r._found[I] = true;
+            } else if constexpr (option_type<I>::repeatable) {
+                if (!r._found[I])
+                    std::get<I>(r._values).emplace_back(std::get<I>(_options).initial_value);
+            }
+        }
+
+        template<typename Option>
+        static void add_option(help_layout & layout, const Option & option, int & n) {
+            if constexpr (Option::positional)
+                layout.positional("<arg-" + std::to_string(++n) + ">", option.help_instruction);
+            else
+                layout.option(option.short_name, option.long_name, option.help_instruction);
+        }
+
+        template<std::size_t... I>
+        result parse(token_table & tokens, std::index_sequence<I...>) const {
+            static constexpr handler handlers[] = {&on_option<I>...};
+
+            result r{};
+            r._values = std::make_tuple(std::get<I>(_options).initial()...);
+            r._found.fill(false);
+
+            for (std::size_t i = tokens.live(0); !tokens.is_terminator(i); i = tokens.live(i + 1)) {
+                std::size_t o = find(tokens[i]);
+                if (o != npos) handlers[o](tokens, i, r);
+            }
+            (finish<I>(tokens, r), ...);
+            return r;
+        }
+
+    public:
+
+        constexpr schema(Options... options) : _options(options...), _names{} {
+            build(std::index_sequence_for<Options...>());
+        }
+
+        //! index of the option with the given short or long name, npos if there is none
+        //! @param name option name
+
+        constexpr std::size_t find(std::string_view name) const {
+            if (name.empty()) return npos;
+            std::size_t first = 0, count = _names.size();
+            while (count > 0) {
+                std::size_t step = count / 2;
+                if (_names[first + step].name < name) {
+                    first += step + 1;
+                    count -= step + 1;
+                } else count = step;
+            }
+            return first < _names.size() && _names[first].name == name ? _names[first].option : npos;
+        }
+
+        //! like find, but a name that is not in the schema does not compile
+        //! @param name option name
+
+        constexpr std::size_t index(std::string_view name) const {
+            std::size_t i = find(name);
+            if (i == npos) throw std::logic_error("unknown option name");
+            return i;
+        }
+
+        //! print the argument lines of the help message, laid out as by arguments::help
+        //! @param os stream
+
+        void print_help(std::ostream & os) const {
+            help_layout layout;
+            int n = 0;
+            std::apply([&layout, &n](const Options &... options) {
+                (add_option(layout, options, n), ...);
+            }, _options);
+            std::string text;
+            layout.append(text);
+            os.write(text.data(), std::streamsize(text.size()));
+        }
+
+        //! match the schema against the command line, before the "--" cutoff
+        //! @param args arguments type that contains the command line input
+
+        result parse(arguments & args) const {
+            return parse(args._command_line_args, std::index_sequence_for<Options...>());
+        }
+    };
+}
+#endif // COMMAND_LINE_SCHEMA_H
@@ -0,0 +1,144 @@
+// ///////////////////////////// MIT License //////////////////////////////////// //
+//                                                                                //
+// Copyright (c) 2013 David Zsolt Manrique                                        //
+//                    david.zsolt.manrique@gmail.com                              //
+//                                                                                //
+// Permission is hereby granted, free of charge, to any person obtaining a copy   //
+// of this software and associated documentation files (the "Software"), to deal  //
+// in the Software without restriction, including without limitation the rights   //
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      //
+// copies of the Software, and to permit persons to whom the Software is          //
+// furnished to do so, subject to the following conditions:                       //
+//                                                                                //
+// The above copyright notice and this permission notice shall be included in     //
+// all copies or substantial portions of the Software.                            //
+//                                                                                //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    //
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  //
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN      //
+// THE SOFTWARE.                                                                  //
+//                                                                                //
+// ////////////////////////////////////////////////////////////////////////////// //
+
+
+#ifndef COMMAND_LINE_SUBCOMMAND_H
+#define COMMAND_LINE_SUBCOMMAND_H
+
+#include "cmdl.h"
+
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+namespace cmdl {
+
+    //!
+    //!  subcommands class
+    //!  dispatches on the first free token that names a subcommand, e.g. "tool build -j 4" or
+    //!  "tool -j 4 build". every subcommand declares its own arguments in its function, on an
+    //!  arguments object that holds the free tokens of the parent without the command, so only
+    //!  the selected subcommand builds and matches its option table. options declared on the
+    //!  parent arguments are global: they are declared before dispatch and take their tokens
+    //!  wherever they are, so a subcommand cannot declare an option of the same name. the
+    //!  parent must not declare positional arguments.
+    //!
+    //!      cmdl::arguments args(argc, argv);
+    //!      cmdl::switcharg<false> verbose(args, "-v", "--verbose", "verbose output");
+    //!      cmdl::subcommands commands(args);
+    //!      commands.add("build", "compile the project", [&](cmdl::arguments & sub) {
+    //!          cmdl::vararg<int> jobs(sub, "-j", "--jobs", "number of jobs", 1);
+    //!          return build(*jobs, *verbose);
+    //!      });
+    //!      return commands.dispatch();
+    //!
+
+    class subcommands {
+    public:
+        typedef std::function<int(arguments &)> function_type;
+
+    protected:
+
+        struct command {
+            std::string name;
+            std::string help_instruction;
+            function_type run;
+        };
+
+        arguments & _arguments;
+        std::deque<command> _commands;
+        std::unordered_map<std::string_view, const command*> _index;
+        std::string_view _selected;
+
+    public:
+
+        explicit subcommands(arguments & args) : _arguments(args) {
+        }
+
+        subcommands(const subcommands &) = delete;
+        subcommands & operator=(const subcommands &) = delete;
+
+        //! add a subcommand
+        //! @param name command name
+        //! @param help_instruction simple help message for this command
+        //! @param run declares the arguments of the command on its arguments and runs it
+
+        void add(std::string_view name, std::string_view help_instruction, function_type run) {
+            if (_index.count(name))
+                throw std::logic_error("Multiple " + std::string(name) + " subcommands");
+            _commands.push_back(command{std::string(name), std::string(help_instruction), std::move(run)});
+            _index.emplace(_commands.back().name, &_commands.back());
+        }
+
+        //! run the subcommand named by the first free token in front of "--" that is a command,
+        //! the free tokens are consumed on the parent
+        //! @return what the subcommand returned
+
+        int dispatch() {
+            token_table & tokens = _arguments._command_line_args;
+            std::size_t position = tokens.live(0), unknown = token_table::npos;
+            auto it = _index.end();
+            for (; !tokens.is_terminator(position); position = tokens.live(position + 1)) {
+                if (tokens.is_option(position)) continue;
+                it = _index.find(tokens[position]);
+                if (it != _index.end()) break;
+                if (unknown == token_table::npos) unknown = position;
+            }
+            if (it == _index.end()) {
+                if (unknown == token_table::npos)
+                    throw std::runtime_error("Wrong command line arguments. Try --help!");
+                throw std::runtime_error("Unknown " + std::string(tokens[unknown]) + " command. Try --help!");
+            }
+            _selected = it->second->name;
+
+            arguments sub(_arguments, position);
+            for (std::size_t i = tokens.live(0); i + 1 < tokens.size(); i = tokens.live(i + 1))
+                tokens.consume(i);
+            return it->second->run(sub);
+        }
+
+        //! name of the dispatched subcommand, empty before dispatch
+
+        std::string_view selected() const {
+            return _selected;
+        }
+
+        //! print the subcommands
+        //! @param os stream
+
+        void print_help(std::ostream & os) const {
+            std::size_t width = 0;
+            for (const command & c : _commands) width = std::max(width, c.name.size());
+
+            std::string text = "Commands:\n";
+            for (const command & c : _commands) {
+                text.append("   ").append(c.name).append(width - c.name.size() + 1, ' ');
+                text.append(c.help_instruction).push_back('\n');
+            }
+            os.write(text.data(), std::streamsize(text.size()));
+        }
+    };
+}
+#endif // COMMAND_LINE_SUBCOMMAND_H
@@ -0,0 +1,288 @@
+// ///////////////////////////// MIT License //////////////////////////////////// //
+//                                                                                //
+// Copyright (c) 2013 David Zsolt Manrique                                        //
+//                    david.zsolt.manrique@gmail.com                              //
+//                                                                                //
+// Permission is hereby granted, free of charge, to any person obtaining a copy   //
+// of this software and associated documentation files (the "Software"), to deal  //
+// in the Software without restriction, including without limitation the rights   //
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      //
+// copies of the Software, and to permit persons to whom the Software is          //
+// furnished to do so, subject to the following conditions:                       //
+//                                                                                //
+// The above copyright notice and this permission notice shall be included in     //
+// all copies or substantial portions of the Software.                            //
+//                                                                                //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    //
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  //
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN      //
+// THE SOFTWARE.                                                                  //
+//                                                                                //
+// ////////////////////////////////////////////////////////////////////////////// //
+
+
+// differential fuzzer: random option schemas and command lines are parsed by cmdl.h, in
+// every conversion mode and with try_parse, and by the original list based implementation
+// (fuzz_cmdl_reference.h). the values, is_set() flags, leftover tokens and error messages
+// have to agree.
+//
+//   fuzz_cmdl [seed] [iterations]         randomized test, run by ctest
+//
+// with -DCMDL_LIBFUZZER=ON (clang) it is a libFuzzer target instead, which decodes the schema
+// and the command line from the input bytes:
+//
+//   cmake -S . -B fuzz -DCMAKE_CXX_COMPILER=clang++ -DCMDL_LIBFUZZER=ON && cmake --build fuzz
+//   fuzz/fuzz_cmdl -max_total_time=60
+//
+// the tokens are drawn from a vocabulary on which both implementations convert alike: the
+// reference reads numbers with operator>>, which accepts "1.5" or "7x" as an int, cmdl.h
+// takes whole tokens only.
+
+#include "cmdl.h"
+// the reference parser is the original cmdl.h, kept verbatim
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wsign-compare"
+#endif
+#include "fuzz_cmdl_reference.h"
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#include <cstdint>
+#include <random>
+
+namespace {
+
+    const char* names[] = {"-a", "--alpha", "-b", "--beta", "-c", "-5", "x"};
+    const char* values[] = {"1", "-2", "+3", "08", "2147483648", "abc", "--", "-a", "-b", "7", "zz", "-c", "-5", "x", "-"};
+    const std::size_t name_count = sizeof (names) / sizeof (names[0]);
+    const std::size_t value_count = sizeof (values) / sizeof (values[0]);
+    const int kinds = 11;
+
+    struct declaration {
+        int kind;
+        std::string short_name;
+        std::string long_name;
+        int length;
+    };
+
+    //! argument kinds of both implementations, by namespace
+
+    struct reference {
+        typedef cmdl_ref::arguments arguments;
+        template<bool V> using switcharg = cmdl_ref::switcharg<V>;
+        template<typename T> using vararg = cmdl_ref::vararg<T>;
+        template<typename T> using multivararg = cmdl_ref::multivararg<T>;
+        template<typename... T> using tuplevararg = cmdl_ref::tuplevararg<T...>;
+        template<typename... T> using muplevararg = cmdl_ref::muplevararg<T...>;
+        template<typename T> using posarg = cmdl_ref::posarg<T>;
+        template<typename T> using multiposarg = cmdl_ref::multiposarg<T>;
+
+        static void conversion(arguments &, int) {
+        }
+    };
+
+    struct current {
+        typedef cmdl::arguments arguments;
+        template<bool V> using switcharg = cmdl::switcharg<V>;
+        template<typename T> using vararg = cmdl::vararg<T>;
+        template<typename T> using multivararg = cmdl::multivararg<T>;
+        template<typename... T> using tuplevararg = cmdl::tuplevararg<T...>;
+        template<typename... T> using muplevararg = cmdl::muplevararg<T...>;
+        template<typename T> using posarg = cmdl::posarg<T>;
+        template<typename T> using multiposarg = cmdl::multiposarg<T>;
+
+        static void conversion(arguments & args, int mode) {
+            args.conversion(cmdl::arguments::conversion_mode(mode));
+        }
+    };
+
+    template<typename Type>
+    void print(std::ostream & os, const Type & value) {
+        os << value;
+    }
+
+    template<typename... Types>
+    void print(std::ostream & os, const std::tuple<Types...> & value) {
+        std::apply([&os](const Types & ... elements) {
+            ((os << elements << '|'), ...);
+        }, value);
+    }
+
+    template<typename Type, typename Allocator>
+    void print(std::ostream & os, const std::vector<Type, Allocator> & value) {
+        os << '[';
+        for (const Type & element : value) {
+            print(os, element);
+            os << ',';
+        }
+        os << ']';
+    }
+
+    //! declare the argument, then print its value and whether it is set. the value is read
+    //! before anything is printed, so a lazy conversion error leaves the same output
+
+    template<typename Arg, typename... Params>
+    void declare(std::ostream & os, std::vector<std::shared_ptr<void> > & keep, const char* label, Params && ... params) {
+        std::shared_ptr<Arg> arg = std::make_shared<Arg>(std::forward<Params>(params)...);
+        keep.push_back(arg);
+        std::ostringstream value;
+        print(value, arg->val());
+        os << label << ' ' << value.str() << ' ' << arg->is_set() << ';';
+    }
+
+    //! declare every argument of a schema, and print their values
+    //! @param keep owns the argument objects
+
+    template<typename Parser>
+    void declare_schema(std::ostream & os, std::vector<std::shared_ptr<void> > & keep, typename Parser::arguments & args, const std::vector<declaration> & schema) {
+        for (const declaration & d : schema)
+            switch (d.kind) {
+                case 0: declare<typename Parser::template switcharg<false> >(os, keep, "sw", args, d.short_name, d.long_name, "h");
+                    break;
+                case 1: declare<typename Parser::template vararg<int> >(os, keep, "vi", args, d.short_name, d.long_name, "h", 7);
+                    break;
+                case 2: declare<typename Parser::template vararg<std::string> >(os, keep, "vs", args, d.short_name, d.long_name, "h", "def");
+                    break;
+                case 3: declare<typename Parser::template multivararg<int> >(os, keep, "mi", args, d.short_name, d.long_name, "h", 3);
+                    break;
+                case 4: declare<typename Parser::template multivararg<std::string> >(os, keep, "ms", args, d.short_name, d.long_name, "h", "d");
+                    break;
+                case 5: declare<typename Parser::template tuplevararg<int, std::string> >(os, keep, "t", args, d.short_name, d.long_name, "h", 1, "x");
+                    break;
+                case 6: declare<typename Parser::template muplevararg<std::string, int> >(os, keep, "m", args, d.short_name, d.long_name, "h", "y", 2);
+                    break;
+                case 7: declare<typename Parser::template posarg<std::string> >(os, keep, "p", args, "h", "pdef");
+                    break;
+                case 8: declare<typename Parser::template multiposarg<std::string> >(os, keep, "mp", args, "h", "mp", d.length);
+                    break;
+                case 9: declare<typename Parser::template posarg<int> >(os, keep, "pi", args, "h", 5);
+                    break;
+                case 10: declare<typename Parser::template multiposarg<int> >(os, keep, "mpi", args, "h", 4, d.length);
+                    break;
+            }
+    }
+
+    //! parse a command line with a schema and describe the outcome
+    //! @param mode conversion mode of cmdl.h
+
+    template<typename Parser>
+    std::string run(const std::string & line, const std::vector<declaration> & schema, int mode) {
+        std::ostringstream os;
+        try {
+            typename Parser::arguments args(line);
+            Parser::conversion(args, mode);
+            std::vector<std::shared_ptr<void> > keep;
+            declare_schema<Parser>(os, keep, args, schema);
+            os << " left:";
+            for (const std::string & token : args.cmdline_args()) os << token << ' ';
+        } catch (const std::exception & e) {
+            os << " error: " << e.what();
+        }
+        return os.str();
+    }
+
+    //! declare the schema on an empty command line, then parse the line without throwing
+    //! @return the error message, empty on success
+
+    std::string try_parse(const std::string & line, const std::vector<declaration> & schema) {
+        std::ostringstream os;
+        cmdl::arguments args("prog");
+        std::vector<std::shared_ptr<void> > keep;
+        declare_schema<current>(os, keep, args, schema);
+        cmdl::parse_result result = args.try_parse(line);
+        return result ? std::string() : result.error().message();
+    }
+
+    //! compare cmdl.h in every conversion mode with the reference. the lazy modes convert after
+    //! the whole match, so when a command line has several errors they may report another one:
+    //! there only the values up to the failing argument and the failure itself have to agree.
+    //! @return false and a report on the first difference
+
+    bool agree(const std::string & line, const std::vector<declaration> & schema, std::ostream & report) {
+        const std::string expected = run<reference>(line, schema, 0);
+        const std::size_t error = expected.find(" error: ");
+        for (int mode = cmdl::arguments::eager; mode <= cmdl::arguments::lazy_checked; mode++) {
+            const std::string actual = run<current>(line, schema, mode);
+            if (actual == expected) continue;
+            if (mode != cmdl::arguments::eager && error != std::string::npos && actual.compare(0, error + 8, expected, 0, error + 8) == 0) continue;
+            report << "command line: " << line << "\nschema:";
+            for (const declaration & d : schema)
+                report << " [" << d.kind << ' ' << d.short_name << ' ' << d.long_name << ' ' << d.length << ']';
+            report << "\nconversion mode: " << mode << "\nreference: " << expected << "\ncmdl.h:    " << actual << '\n';
+            return false;
+        }
+
+        // try_parse on arguments declared beforehand returns the error the reference throws
+        std::string thrown = error == std::string::npos ? std::string() : expected.substr(error + 8);
+        std::string returned = try_parse(line, schema);
+        if (returned == thrown) return true;
+        report << "command line: " << line << "\nreference: " << thrown << "\ntry_parse: " << returned << '\n';
+        return false;
+    }
+
+    //! schema and command line from bytes, each byte picks one item
+
+    struct byte_source {
+        const std::uint8_t* data;
+        std::size_t size;
+
+        std::size_t next(std::size_t range) {
+            if (size == 0) return 0;
+            size--;
+            return *data++ % range;
+        }
+    };
+}
+
+#ifdef CMDL_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t * data, std::size_t size) {
+    byte_source bytes{data, size};
+    std::vector<declaration> schema(1 + bytes.next(6));
+    for (declaration & d : schema)
+        d = declaration{int(bytes.next(kinds)), names[bytes.next(name_count)], names[bytes.next(name_count)], int(bytes.next(3))};
+
+    std::string line = "prog";
+    while (bytes.size)
+        line.append(" ").append(bytes.next(2) ? names[bytes.next(name_count)] : values[bytes.next(value_count)]);
+    if (!agree(line, schema, std::cerr)) std::abort();
+
+    // any input, only for crashes
+    try {
+        cmdl::arguments args("prog " + std::string(reinterpret_cast<const char*> (data), size));
+        cmdl::vararg<int> number(args, "-a", "--alpha", "h", 0);
+        cmdl::multivararg<std::string> strings(args, "-b", "--beta", "h", "");
+        cmdl::listvararg<double> list(args, "-c", "--gamma", "h", 0.0);
+        cmdl::multiposarg<std::string> rest(args, "h", "");
+    } catch (const std::exception &) {
+    }
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv) {
+    std::mt19937 rng(argc > 1 ? std::atoi(argv[1]) : 1);
+    const long iterations = argc > 2 ? std::atol(argv[2]) : 20000;
+
+    for (long i = 0; i < iterations; i++) {
+        std::vector<declaration> schema(1 + rng() % 6);
+        for (declaration & d : schema)
+            d = declaration{int(rng() % kinds), names[rng() % name_count], names[rng() % name_count], int(rng() % 3)};
+
+        std::string line = "prog";
+        for (std::size_t n = rng() % 14; n > 0; n--)
+            line.append(" ").append(rng() % 2 ? names[rng() % name_count] : values[rng() % value_count]);
+
+        if (!agree(line, schema, std::cout)) return EXIT_FAILURE;
+    }
+    std::cout << iterations << " command lines agree" << std::endl;
+    return EXIT_SUCCESS;
+}
+
+#endif
@@ -25,11 +25,589 @@
 
 
 #include "cmdl.h"
+#include "cmdl_batch.h"
+#include "cmdl_completion.h"
+#include "cmdl_schema.h"
+#include "cmdl_subcommand.h"
 
 using namespace cmdl;
 
+// checks of the extensions, silent unless one fails
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    if (ok) return;
+    std::cerr << "FAILED: " << what << std::endl;
+    failures++;
+}
+
+constexpr schema build_options{
+    spec::switcharg<false>{"-h", "--help", "print help"},
+    spec::vararg<int>{"-n", "--number", "number of jobs", 1},
+    spec::multivararg<std::string>{"-t", "--tag", "tags,\ngiven more than once", "none"},
+    spec::posarg<std::string>{"input file", "in.txt"}};
+
+// a listvararg parsed from a single token, given as one argv entry to keep its whitespace.
+// it is declared on the program name alone, so that try_parse reports the errors
+
+template<typename Type>
+parse_result parse_list(const std::string & token, std::vector<Type> & items) {
+    std::string program = "program", option = "-x", value = token;
+    char* argv[] = {&program[0], &option[0], &value[0], nullptr};
+    arguments args(1, argv);
+    listvararg<Type> list(args, "-x", "--list", "list", Type());
+    parse_result r = args.try_parse(3, argv);
+    if (r) items = *list;
+    return r;
+}
+
+void test_listvararg() {
+    std::vector<int> ints;
+    for (const char* token :{"1,2,3", "1 2 3", "1, 2 ,3", "1\t2\n3\r\n", "  1,2,3  ", "1 ,\t2,  3"})
+        check(parse_list(token, ints) && ints == std::vector<int>{1, 2, 3}, "list separators");
+
+    // long enough to span several 16 byte blocks, with signs
+    check(parse_list("-5,+6,1000000,-2147483648,2147483647,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,42", ints) && ints.size() == 26
+            && ints[0] == -5 && ints[1] == 6 && ints[3] == -2147483648LL && ints[4] == 2147483647 && ints[25] == 42, "long list");
+
+    // empty items, leading and trailing commas, bad characters and out of range values
+    for (const char* token :{"1,,2", ",1", "1,", ",", "1, ,2", "1a", "1,2,3,4,5,6,7,8,9,1x", "0x10", "1.5", "1,-", "1,+",
+            "2147483648", "-2147483649", "99999999999999999999"}) {
+        parse_result r = parse_list(token, ints);
+        check(!r && r.error().code == parse_error::conversion && r.error().option == "--list", "wrong list");
+    }
+    try {
+        arguments args("program -x 1,,2");
+        listvararg<int> list(args, "-x", "--list", "list", 0);
+        check(false, "wrong list throws");
+    } catch (const std::runtime_error & e) {
+        check(std::string(e.what()) == "Wrong command line arguments. Try --help!", "wrong list message");
+    }
+
+    std::vector<unsigned> naturals;
+    check(parse_list("0 4294967295", naturals) && naturals == std::vector<unsigned>{0, 4294967295u}, "unsigned list");
+    check(!parse_list("4294967296", naturals) && !parse_list("1,-1", naturals), "unsigned list out of range");
+
+    std::vector<double> reals;
+    check(parse_list("0.5,1e3 -2.25,+.125", reals) && reals == std::vector<double>{0.5, 1000.0, -2.25, 0.125}, "double list");
+    check(!parse_list("0.5,,1", reals) && !parse_list("0.5x", reals) && !parse_list("1e999", reals), "wrong double list");
+
+    // the initial value when the option is not given
+    arguments args("program");
+    listvararg<int> list(args, "-x", "--list", "list", 7);
+    check(*list == std::vector<int>{7} && !list.is_set(), "list initial value");
+}
+
+void test_schema() {
+    static_assert(build_options.index("-n") == 1 && build_options.index("--number") == 1 && build_options.index("--tag") == 2, "schema index");
+    static_assert(build_options.find("--missing") == build_options.npos && build_options.find("") == build_options.npos, "schema find");
+
+    // the schema takes its options and the first positional, later arguments see the rest
+    arguments args("program -t a -n 4 file.txt -t b -x 2 rest");
+    auto r = build_options.parse(args);
+    vararg<int> extra(args, "-x", "--extra", "extra", 0);
+    posarg<std::string> rest(args, "rest", "");
+    check(r.val<build_options.index("--number")>() == 4 && r.is_set<1>(), "schema value");
+    check(r.val<build_options.index("-t")>() == std::vector<std::string>{"a", "b"}, "schema repeated value");
+    check(!r.val<0>() && !r.is_set<0>(), "schema switch");
+    check(r.val<3>() == "file.txt" && r.is_set<3>(), "schema positional");
+    check(*extra == 2 && *rest == "rest", "arguments after the schema");
+
+    // initial values
+    arguments none("program");
+    auto d = build_options.parse(none);
+    check(d.val<1>() == 1 && d.val<2>() == std::vector<std::string>{"none"} && d.val<3>() == "in.txt" && !d.is_set<3>(), "schema initial values");
+
+    try {
+        arguments twice("program -n 1 -n 2");
+        build_options.parse(twice);
+        check(false, "schema multiple option");
+    } catch (const std::runtime_error & e) {
+        check(std::string(e.what()) == "Multiple -n command line arguments. Try --help!", "schema multiple option message");
+    }
+
+    std::ostringstream os;
+    build_options.print_help(os);
+    check(os.str() ==
+            "   <arg-1> input file\n"
+            "   -h --help   print help\n"
+            "   -n --number number of jobs\n"
+            "   -t --tag    tags,\n"
+            "               given more than once\n", "schema help");
+}
+
+void write_file(const char* path, const char* text) {
+    std::ofstream os(path, std::ios::binary);
+    os << text;
+}
+
+void test_response_files() {
+    write_file("test_cmdl_outer.rsp", "# options of the build\n-n 3 @test_cmdl_inner.rsp\n'single quoted' \"double \\\"quoted\\\"\" # the files\n");
+    write_file("test_cmdl_inner.rsp", "--name 'from inner' '@test_cmdl_inner.rsp'\n");
+    write_file("test_cmdl_loop.rsp", "-n 1 @test_cmdl_loop_back.rsp\n");
+    write_file("test_cmdl_loop_back.rsp", "@test_cmdl_loop.rsp\n");
+    write_file("test_cmdl_open.rsp", "-n 1 'not closed\n");
+
+    // nested files, comments and quotes; a quoted @file in a file stays literal
+    arguments args("program @test_cmdl_outer.rsp last");
+    vararg<int> number(args, "-n", "--number", "number", 0);
+    vararg<std::string> name(args, "-s", "--name", "name", "");
+    multiposarg<std::string> files(args, "files", "");
+    check(*number == 3 && *name == "from inner", "nested response files");
+    check(*files == std::vector<std::string>{"@test_cmdl_inner.rsp", "single quoted", "double \"quoted\"", "last"}, "response file tokens");
+
+    // an unreadable file and a quoted @file on the command line stay literal
+    args.parse("program @test_cmdl_missing.rsp '@test_cmdl_outer.rsp'");
+    check(*number == 0 && *files == std::vector<std::string>{"@test_cmdl_missing.rsp", "@test_cmdl_outer.rsp"}, "literal @file tokens");
+
+    // a file that includes itself through another one, and an open quote in a file
+    try {
+        args.parse("program @test_cmdl_loop.rsp");
+        check(false, "recursive response file");
+    } catch (const std::runtime_error & e) {
+        check(std::string(e.what()) == "Recursive @test_cmdl_loop.rsp response file. Try --help!", "recursive response file message");
+    }
+    check(args.try_parse("program @test_cmdl_loop.rsp").error().code == parse_error::recursive_file, "recursive response file code");
+    try {
+        args.parse("program @test_cmdl_open.rsp");
+        check(false, "unterminated quote in a response file");
+    } catch (const std::runtime_error & e) {
+        check(std::string(e.what()) == "Unterminated quote in @test_cmdl_open.rsp response file. Try --help!", "unterminated quote in a response file message");
+    }
+    check(args.try_parse("program @test_cmdl_open.rsp").error().code == parse_error::unterminated_quote, "unterminated quote in a response file code");
+
+    for (const char* path :{"test_cmdl_outer.rsp", "test_cmdl_inner.rsp", "test_cmdl_loop.rsp", "test_cmdl_loop_back.rsp", "test_cmdl_open.rsp"})
+        std::remove(path);
+}
+
+void test_update() {
+    arguments args("program");
+    vararg<int> number(args, "-n", "--number", "number", 0);
+    vararg<int> level(args, "-l", "--level", "level", 0);
+    switcharg<false> quiet(args, "-q", "--quiet", "quiet");
+    multiposarg<std::string> files(args, "files", "");
+    typedef std::vector<const basearg*> diff;
+
+    check(args.update("program -n 1 -l 2 a") == diff{&number, &level, &quiet, &files}, "first update");
+    check(args.update("program -n 1 -l 3 a") == diff{&level}, "changed value");
+    check(args.update("program -q -n 1 -l 3 a") == diff{&quiet}, "added switch");
+    check(args.update("program -l 3 a -q -n 1") == diff{}, "reordered tokens");
+    check(args.update("program -l 3 a b -q -n 1") == diff{&files}, "added positional");
+
+    // the changes of an update that threw are reported by the next one
+    try {
+        args.update("program -n 5 -l x a b -q");
+        check(false, "failed update");
+    } catch (const std::runtime_error &) {
+    }
+    check(args.update("program -n 5 -l 4 a b -q") == diff{&number, &level}, "update after a failed one");
+    check(*number == 5 && *level == 4 && *quiet && (*files).size() == 2, "values after a failed update");
+}
+
+void test_help() {
+    arguments args("program");
+    posarg<std::string> input(args, "input", "");
+    multiposarg<std::string> more(args, "more files", "", 3);
+    vararg<int> number(args, "-n", "--number", "number of jobs\nat most 64", 1);
+    switcharg<false> verbose(args, "-verb", "--a-very-long-option", "verbose");
+
+    // the columns are as wide as the longest label and names, a second help line is indented
+    const std::string help =
+            "Usage: program <arg-1> <arg-2...4>  -[option] <option-arg>\n"
+            "   <arg-1>     input\n"
+            "   <arg-2...4> more files\n"
+            "   -n    --number             number of jobs\n"
+            "                              at most 64\n"
+            "   -verb --a-very-long-option verbose\n";
+    const std::string completion =
+            "posarg\t\t\t1\tstring\tinput\n"
+            "multiposarg\t\t\t3\tstring\tmore files\n"
+            "vararg\t-n\t--number\t1\tint\tnumber of jobs\\nat most 64\n"
+            "switcharg\t-verb\t--a-very-long-option\t0\t\tverbose\n";
+    check(args.help() == help, "help layout");
+    check(args.completion() == completion, "completion data");
+
+    // the cached texts follow the declared arguments and the program name
+    {
+        multiposarg<int> rest(args, "rest", 0);
+        check(args.help() ==
+                "Usage: program <arg-1> <arg-2...4> <arg-5... >  -[option] <option-arg>\n"
+                "   <arg-1>     input\n"
+                "   <arg-2...4> more files\n"
+                "   <arg-5... > rest\n"
+                "   -n    --number             number of jobs\n"
+                "                              at most 64\n"
+                "   -verb --a-very-long-option verbose\n", "help after a declaration");
+        check(args.completion() == completion + "multiposarg\t\t\t0\tint\trest\n", "completion after a declaration");
+    }
+    check(args.help() == help, "help after a destruction");
+    check(args.completion() == completion, "completion after a destruction");
+    args.parse("other");
+    check(args.help().compare(0, 21, "Usage: other <arg-1> ") == 0, "help of another program name");
+
+    std::ostringstream os;
+    args.print_help(os);
+    check(os.str() == args.help(), "print_help");
+}
+
+void test_completion() {
+    arguments args("program");
+    vararg<int> number(args, "-n", "--number", "number of jobs\twith a tab\nand a new line", 1);
+    multivararg<std::string> tags(args, "-t", "--tag", "tags", "");
+    tuplevararg<int, double> range(args, "-r", "--range", "range", 0, 0.0);
+    multiposarg<std::string> files(args, "files", "", 2);
+
+    check(args.completion().find("number of jobs\\twith a tab\\nand a new line\n") != std::string::npos, "completion escapes the help");
+
+    completer c(args);
+    std::vector<completer::candidate> x = c.complete("program --", 10);
+    check(x.size() == 3 && x[0].text == "--number" && x[0].type == "int" && x[0].help == "number of jobs\twith a tab\nand a new line"
+            && x[1].text == "--range" && x[2].text == "--tag", "long option names");
+
+    // a single option is offered once, a repeatable one again
+    x = c.complete("program -n 4 -t a -", 19);
+    check(x.size() == 4 && x[0].text == "--range" && x[1].text == "--tag" && x[2].text == "-r" && x[3].text == "-t", "used options");
+
+    x = c.complete("program -r 1 ", 13);
+    check(x.size() == 1 && x[0].kind == completer::candidate::value && x[0].type == "float", "second tuple value");
+
+    x = c.complete("program a b ", 12);
+    check(x.size() == 6 && x.back().kind == completer::candidate::option, "positionals taken");
+    x = c.complete("program a ", 10);
+    check(x.size() == 7 && x.back().kind == completer::candidate::positional && x.back().help == "files", "next positional");
+}
+
+void test_subcommands() {
+    for (const char* line : {"tool -v build -j 4 a.c", "tool -j 4 build a.c -v"}) {
+        arguments args(line);
+        switcharg<false> verbose(args, "-v", "--verbose", "verbose output");
+        subcommands commands(args);
+        commands.add("run", "run the project", [](arguments &) {
+            return 1;
+        });
+        commands.add("build", "compile the project", [&](arguments & sub) {
+            vararg<int> jobs(sub, "-j", "--jobs", "number of jobs", 1);
+            multiposarg<std::string> files(sub, "files", "");
+            check(sub.name() == "tool build" && *jobs == 4 && (*files).size() == 1 && (*files)[0] == "a.c" && *verbose, "subcommand arguments");
+            return 2;
+        });
+        check(commands.dispatch() == 2 && commands.selected() == "build", "dispatch");
+        check(args.cmdline_args().size() == 1, "subcommand tokens consumed");
+    }
+
+    arguments args("tool bulid");
+    subcommands commands(args);
+    commands.add("build", "compile the project", [](arguments &) {
+        return 0;
+    });
+    try {
+        commands.dispatch();
+        check(false, "unknown command");
+    } catch (const std::runtime_error & e) {
+        check(std::string(e.what()) == "Unknown bulid command. Try --help!", "unknown command");
+    }
+}
+
+void test_streamposarg() {
+    std::istringstream more("4\r\n\n5\n");
+    arguments args("program -n 2 1 2 3 -- 9");
+    vararg<int> n(args, "-n", "--number", "number", 0);
+    streamposarg<int> items(args, "items", &more);
+    check(*n == 2 && items.is_set(), "streamposarg set");
+
+    std::vector<int> pulled;
+    for (int item : *items) pulled.push_back(item);
+    check(pulled == std::vector<int>({1, 2, 3, 4, 5}), "command line items, then continuation lines");
+    check(args.cmdline_args().size() == 3, "items consumed, not the ones after --");
+
+    arguments bad("program 1 x");
+    streamposarg<int> numbers(bad, "numbers");
+    stream_range<int>::iterator it = (*numbers).begin();
+    try {
+        ++it;
+        check(false, "streamposarg conversion error");
+    } catch (const std::runtime_error &) {
+    }
+}
+
+void set_environment(const char* name, const char* value) {
+#if defined(_WIN32)
+    _putenv_s(name, value);
+#else
+    setenv(name, value, 1);
+#endif
+}
+
+void unset_environment(const char* name) {
+#if defined(_WIN32)
+    _putenv_s(name, "");
+#else
+    unsetenv(name);
+#endif
+}
+
+void test_sources() {
+    {
+        std::ofstream os("test_cmdl.conf");
+        os << "jobs = 2\nname = \"from config\"\nquiet = no\nfiles = 'my file.txt' plain\n[build]\ntarget = release\n";
+    }
+    set_environment("TEST_CMDL_JOBS", "3");
+    set_environment("TEST_CMDL_QUIET", "yes");
+    set_environment("TEST_CMDL_FAST", "1");
+
+    // the command line first, then the environment, then the config file
+    arguments args("program --name given");
+    args.environment("TEST_CMDL_");
+    check(args.config("test_cmdl.conf"), "config file read");
+    vararg<int> jobs(args, "-j", "--jobs", "number of jobs", 1);
+    vararg<std::string> name(args, "-n", "--name", "name", "");
+    switcharg<false> quiet(args, "-q", "--quiet", "quiet");
+    switcharg<true> fast(args, "-f", "--fast", "fast");
+    multivararg<std::string> files(args, "-i", "--files", "input files", "");
+    vararg<std::string> target(args, "-t", "--build.target", "target", "debug");
+    vararg<int> missing(args, "-m", "--missing", "not in any source", 7);
+
+    check(*name == "given" && *jobs == 3 && *quiet && *fast && fast.is_set() && *target == "release" && *missing == 7 && !missing.is_set(), "source precedence");
+    check(*files == std::vector<std::string>({"my file.txt", "plain"}), "quoted config values");
+
+    args.parse("program --fast -n x");
+    check(!*fast && *name == "x", "command line switch over the environment");
+
+    set_environment("TEST_CMDL_QUIET", "maybe");
+    parse_result result = args.try_parse("program");
+    check(!result && result.error().code == parse_error::source_value && result.error().option == "--quiet", "wrong switch value");
+
+    // an empty variable is not given, the config file value is taken
+    set_environment("TEST_CMDL_JOBS", "");
+    set_environment("TEST_CMDL_QUIET", "");
+    set_environment("TEST_CMDL_FAST", "");
+    args.parse("program");
+    check(*jobs == 2 && jobs.is_set() && !*quiet && *fast && !fast.is_set(), "empty environment variables");
+
+    unset_environment("TEST_CMDL_JOBS");
+    unset_environment("TEST_CMDL_QUIET");
+    unset_environment("TEST_CMDL_FAST");
+    check(std::getenv("TEST_CMDL_JOBS") == nullptr, "unset environment variable");
+    std::remove("test_cmdl.conf");
+}
+
+void test_save_load() {
+    const char* line = "program -n 4 --name job -i 1 -i 2 -t 1.5 3 -b 1 -m x 1 -m y 2 a b";
+    arguments saved(line);
+    vararg<int> n(saved, "-n", "--number", "number", 0);
+    vararg<std::string> name(saved, "-s", "--name", "name", "");
+    multivararg<int> ids(saved, "-i", "--id", "ids", 0);
+    tuplevararg<double, int> t(saved, "-t", "--tuple", "tuple", 0.0, 0);
+    vararg<bool> flag(saved, "-b", "--bool", "bool", false);
+    muplevararg<std::string, int> pairs(saved, "-m", "--muple", "pairs", "", 0);
+    switcharg<false> help(saved, "-h", "--help", "help");
+    multiposarg<std::string> rest(saved, "rest", "");
+    check(saved.save("test_cmdl.args"), "save");
+
+    arguments loaded("program");
+    vararg<int> n2(loaded, "-n", "--number", "number", 0);
+    vararg<std::string> name2(loaded, "-s", "--name", "name", "");
+    multivararg<int> ids2(loaded, "-i", "--id", "ids", 0);
+    tuplevararg<double, int> t2(loaded, "-t", "--tuple", "tuple", 0.0, 0);
+    vararg<bool> flag2(loaded, "-b", "--bool", "bool", false);
+    muplevararg<std::string, int> pairs2(loaded, "-m", "--muple", "pairs", "", 0);
+    switcharg<false> help2(loaded, "-h", "--help", "help");
+    multiposarg<std::string> rest2(loaded, "rest", "");
+    check(loaded.load("test_cmdl.args"), "load");
+    check(*n2 == 4 && n2.is_set() && *name2 == "job" && *ids2 == *ids && *t2 == *t && *flag2 && *pairs2 == *pairs
+            && !*help2 && !help2.is_set() && *rest2 == *rest, "save and load round trip");
+    std::remove("test_cmdl.args");
+
+    // corrupt header fields and values, each one is rejected
+    const std::string blob = saved.serialize();
+    auto rejected = [&loaded, &blob](std::size_t offset, char byte, const char* message) {
+        std::string corrupt = blob;
+        corrupt[offset] = byte;
+        try {
+            loaded.deserialize(corrupt);
+        } catch (const std::runtime_error & e) {
+            return std::string(e.what()) == message;
+        }
+        return false;
+    };
+    const char* wrong = "Wrong saved arguments. Try --help!";
+    const char* mismatched = "Mismatched saved arguments. Try --help!";
+    const std::size_t header = 4 + 4 + 8 + 8, name_length = header + 1 + sizeof (int) + 1, ids_length = name_length + 8 + 3 + 1;
+    check(rejected(0, 'X', wrong), "corrupt magic");
+    check(rejected(4, 2, mismatched), "corrupt version");
+    check(rejected(8, char(blob[8] ^ 1), mismatched), "corrupt signature");
+    check(rejected(16, 9, mismatched), "corrupt count");
+    check(rejected(header, 7, wrong), "corrupt is_set byte");
+    check(rejected(header + 1 + sizeof (int) + 1 + 8 + 3, 2, wrong), "corrupt is_set byte of a vector");
+    check(rejected(name_length, 2, wrong), "short string length");
+    check(rejected(name_length + 7, char(0x7f), wrong), "long string length");
+    check(rejected(ids_length + 7, char(0x7f), wrong), "long vector length");
+    // the switch value in front of the positionals: set, size, "a" and "b"
+    check(rejected(blob.size() - (1 + 8 + 2 * (8 + 1)) - 1, 7, wrong), "corrupt bool value");
+    try {
+        loaded.deserialize(blob.substr(0, blob.size() - 1));
+        check(false, "truncated blob");
+    } catch (const std::runtime_error & e) {
+        check(std::string(e.what()) == wrong, "truncated blob");
+    }
+    try {
+        loaded.deserialize(blob + '\0');
+        check(false, "trailing bytes");
+    } catch (const std::runtime_error & e) {
+        check(std::string(e.what()) == wrong, "trailing bytes");
+    }
+
+    // a different declaration does not load, also for the same names and value sizes
+    auto mismatch = [mismatched](const arguments & from, arguments & to) {
+        try {
+            to.deserialize(from.serialize());
+        } catch (const std::runtime_error & e) {
+            return std::string(e.what()) == mismatched;
+        }
+        return false;
+    };
+    arguments other("program");
+    vararg<long> n3(other, "-n", "--number", "number", 0);
+    check(mismatch(saved, other), "mismatched arguments");
+
+    arguments negative("program -n -1");
+    vararg<int> n4(negative, "-n", "--number", "number", 0);
+    arguments as_unsigned("program");
+    vararg<unsigned> n5(as_unsigned, "-n", "--number", "number", 0);
+    arguments as_float("program");
+    vararg<float> n6(as_float, "-n", "--number", "number", 0);
+    check(mismatch(negative, as_unsigned) && *n5 == 0, "int loaded as unsigned");
+    check(mismatch(negative, as_float) && *n6 == 0, "int loaded as float");
+}
+
+
+// a value type whose conversion throws on 13, as a user type may
+
+struct unlucky {
+    int value = 0;
+};
+
+std::istream & operator>>(std::istream & is, unlucky & u) {
+    if ((is >> u.value) && u.value == 13) throw std::runtime_error("Unlucky value");
+    return is;
+}
+
+std::ostream & operator<<(std::ostream & os, const unlucky & u) {
+    return os << u.value;
+}
+
+void test_batch() {
+    parser p;
+    auto jobs = p.add<vararg<int> >("-j", "--jobs", "jobs", 1);
+    auto name = p.add<vararg<std::string> >("-n", "--name", "name", "none");
+    auto luck = p.add<vararg<unlucky> >("-u", "--unlucky", "unlucky", unlucky());
+    auto files = p.add<multiposarg<std::string> >("files", "");
+
+    // enough lines for several chunks; every 7th line is wrong, every 11th throws
+    std::string manifest = "# jobs\n\n";
+    for (int i = 0; i < 40000; i++) {
+        manifest += "tool -j " + std::to_string(i) + " --name job" + std::to_string(i);
+        if (i % 7 == 3) manifest += " -j 2";
+        if (i % 11 == 5) manifest += " -u 13";
+        manifest += i % 2 ? " a b\n" : "\r\n";
+    }
+
+    batch b(p);
+    batch::report one = b.validate(manifest, 1);
+    check(one.size() == 40000 && one.line(0) == 3 && one.line(39999) == 40002, "batch lines");
+    std::size_t errors = 0;
+    for (int i = 0; i < 40000; i++) {
+        bool wrong = i % 7 == 3, thrown = i % 11 == 5 && !wrong;
+        errors += wrong || thrown;
+        if (wrong) check(one.code(i) == parse_error::multiple && one.token(i) == 4
+                && one.message(i) == "Multiple -j command line arguments. Try --help!", "batch error");
+        else if (thrown) check(one.code(i) == parse_error::exception && one.token(i) == parse_error::npos
+                && one.message(i) == "Unlucky value" && !one.is_set(jobs, i), "batch exception");
+        else check(one.ok(i) && one.value(jobs, i) == i && one.value(name, i) == "job" + std::to_string(i)
+                && !one.is_set(luck, i) && one.value(files, i).size() == std::size_t(i % 2 ? 2 : 1), "batch values");
+    }
+    check(one.errors() == errors, "batch errors");
+
+    for (unsigned threads : {2u, 4u}) {
+        batch::report r = b.validate(manifest, threads);
+        bool same = r.size() == one.size() && r.errors() == one.errors();
+        for (std::size_t i = 0; same && i < r.size(); i++)
+            same = r.line(i) == one.line(i) && r.code(i) == one.code(i) && r.token(i) == one.token(i) && r.message(i) == one.message(i)
+                && r.value(jobs, i) == one.value(jobs, i) && r.value(name, i) == one.value(name, i) && r.value(files, i) == one.value(files, i);
+        check(same, "batch report across threads");
+    }
+
+    // the text report of every line, and of the invalid ones
+    parser small;
+    small.add<switcharg<false> >("-q", "--quiet", "quiet");
+    small.add<vararg<double> >("-w", "", "weight", 0.5);
+    small.add<muplevararg<std::string, int> >("-m", "--map", "pairs", "", 0);
+    small.add<multiposarg<std::string> >("files", "");
+    batch::report text = batch(small).validate("tool -w 0.1 -m 'a b' 1 -m \"t\\\\ab\" 2 x y\n# comment\ntool -w\ntool -q\n", 2);
+    std::ostringstream os;
+    text.print(os);
+    check(os.str() ==
+            "line\tcode\ttoken\tmessage\tquiet\tw\tmap\targ-1\n"
+            "1\t0\t-\t\t0\t0.10000000000000001\ta b 1,t\\\\ab 2\tx,y\n"
+            "3\t1\t0\tWrong command line arguments. Try --help!\t\t\t\t\n"
+            "4\t0\t-\t\t1\t0.5\t 0\t\n", "batch text report");
+    os.str("");
+    text.print_errors(os);
+    check(os.str() == "3\t0\tWrong command line arguments. Try --help!\n", "batch error report");
+
+    // a report cannot hold a stream
+    parser streams;
+    streams.add<streamposarg<int> >("numbers");
+    try {
+        batch bad(streams);
+        check(false, "batch of streamposarg");
+    } catch (const std::runtime_error &) {
+    }
+}
+
+void test_quoting() {
+    // quotes and escapes of the string constructor, also across the 16 byte blocks of the scan
+    const std::string line = "program --name 'a  b' -t \"say \\\"hi\\\" to a long \\\\ list of people\" 1 "
+            "plain\\ text\\\\ '@not_a_file' \"\" it\\'s 'single \"double\" inside' \"x\"'y'z";
+    arguments args(line);
+    vararg<std::string> name(args, "-s", "--name", "name", "");
+    tuplevararg<std::string, int> t(args, "-t", "--tuple", "tuple", "", 0);
+    multiposarg<std::string> rest(args, "rest", "");
+    check(*name == "a  b", "single quotes");
+    check(std::get<0>(*t) == "say \"hi\" to a long \\ list of people" && std::get<1>(*t) == 1, "double quotes");
+    check(*rest == std::vector<std::string>{"plain text\\", "@not_a_file", "", "it's", "single \"double\" inside", "xyz"}, "escapes");
+    check(args.cmdline() == line, "cmdline keeps the quotes");
+
+    // an unterminated quote
+    for (const char* open :{"program 'a b", "program \"a b", "program \"a \\\""}) {
+        try {
+            arguments bad(open);
+            check(false, "unterminated quote");
+        } catch (const std::runtime_error & e) {
+            check(std::string(e.what()) == "Unterminated quote in command line. Try --help!", "unterminated quote message");
+        }
+        arguments quiet("program");
+        parse_result r = quiet.try_parse(open);
+        check(r.error().code == parse_error::unterminated_quote, "unterminated quote code");
+    }
+}
+
 int main(int argc, char **argv) {
 
+    test_schema();
+    test_listvararg();
+    test_response_files();
+    test_update();
+    test_help();
+    test_completion();
+    test_subcommands();
+    test_streamposarg();
+    test_sources();
+    test_save_load();
+    test_batch();
+    test_quoting();
+
     //arguments arg(argc, argv);
 
     arguments arg("program -mvad 1.1 -vad -2.2 -vai -1 -vas str -mvad 2.2 -t1 3.3 -t3 4.4 4 str -mt3 5.5 5 str1 -mvad 3.3 -mt3 6.6 6 str2 1 a b c d e f g h i 2");
@@ -102,5 +680,6 @@ int main(int argc, char **argv) {
 
     arg.print_all();
 
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
 }
 
@@ -0,0 +1,99 @@
+// ///////////////////////////// MIT License //////////////////////////////////// //
+//                                                                                //
+// Copyright (c) 2013 David Zsolt Manrique                                        //
+//                    david.zsolt.manrique@gmail.com                              //
+//                                                                                //
+// Permission is hereby granted, free of charge, to any person obtaining a copy   //
+// of this software and associated documentation files (the "Software"), to deal  //
+// in the Software without restriction, including without limitation the rights   //
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      //
+// copies of the Software, and to permit persons to whom the Software is          //
+// furnished to do so, subject to the following conditions:                       //
+//                                                                                //
+// The above copyright notice and this permission notice shall be included in     //
+// all copies or substantial portions of the Software.                            //
+//                                                                                //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    //
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  //
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN      //
+// THE SOFTWARE.                                                                  //
+//                                                                                //
+// ////////////////////////////////////////////////////////////////////////////// //
+
+// the statistics of a build with CMDL_STATS, silent unless a check fails
+
+#include "cmdl.h"
+
+#ifndef CMDL_STATS
+#error test_cmdl_stats is built with -DCMDL_STATS
+#endif
+
+#include <sstream>
+
+using namespace cmdl;
+
+int failures = 0;
+
+void check(bool ok, const char* what) {
+    if (ok) return;
+    std::cerr << "FAILED: " << what << std::endl;
+    failures++;
+}
+
+void test_counts() {
+    {
+        std::ofstream os("test_cmdl_stats.rsp");
+        os << "-t c\n";
+    }
+    arguments args("program -n 1 -t a -t b x");
+    vararg<int> number(args, "-n", "--number", "number", 0);
+    multivararg<std::string> tags(args, "-t", "--tag", "tags", "");
+    posarg<std::string> file(args, "file", "");
+    {
+        vararg<int> erased(args, "-x", "--extra", "extra", 0);
+    }
+    args.parse("program -n 2 @test_cmdl_stats.rsp y");
+    std::remove("test_cmdl_stats.rsp");
+
+    parse_stats s = args.stats();
+    check(s.tokenizations == 2 && s.tokens == 5 && s.files == 1, "tokenizer counts");
+    check(s.declared == 4 && s.undeclared == 1 && s.erasures == 0, "declaration counts");
+    check(s.allocations > 0 && s.allocated_bytes > 0, "allocation counts");
+    check(s.options.size() == 3 && s.options[0].kind == "vararg" && s.options[0].short_name == "-n" && s.options[0].long_name == "--number"
+            && s.options[2].kind == "posarg" && s.options[2].long_name.empty(), "options");
+    const option_stats & n = s.options[0].stats, & t = s.options[1].stats;
+    check(n.parses == 2 && n.occurrences == 2 && n.conversions == 2, "counts of a single option");
+    check(t.parses == 2 && t.occurrences == 3 && t.conversions == 3, "counts of a repeatable option");
+    check(n.convert_ns <= n.parse_ns, "conversion time within the parse time");
+
+    std::ostringstream os;
+    s.print_json(os);
+    const std::string head = "{\"tokenizations\":2,\"tokens\":5,\"files\":1,\"tokenize_ns\":";
+    check(os.str().compare(0, head.size(), head) == 0
+            && os.str().find(",\"declared\":4,\"undeclared\":1,\"erasures\":0,\"allocations\":") != std::string::npos
+            && os.str().find("{\"kind\":\"multivararg\",\"short_name\":\"-t\",\"long_name\":\"--tag\",\"parses\":2,\"occurrences\":3,\"conversions\":3,\"parse_ns\":") != std::string::npos,
+            "json of a parse");
+}
+
+void test_json() {
+    parse_stats s;
+    s.tokenizations = 1;
+    s.tokens = 2;
+    s.tokenize_ns = 30;
+    s.declared = 1;
+    s.options.push_back(parse_stats::option{"vararg", "-q", "--\"quoted\\\"\n", option_stats{1, 2, 3, 40, 5}});
+    std::ostringstream os;
+    s.print_json(os);
+    check(os.str() == "{\"tokenizations\":1,\"tokens\":2,\"files\":0,\"tokenize_ns\":30,\"declared\":1,\"undeclared\":0,\"erasures\":0,"
+            "\"allocations\":0,\"allocated_bytes\":0,\"options\":[{\"kind\":\"vararg\",\"short_name\":\"-q\",\"long_name\":\"--\\\"quoted\\\\\\\"\\u000a\","
+            "\"parses\":1,\"occurrences\":2,\"conversions\":3,\"parse_ns\":40,\"convert_ns\":5}]}", "json escapes");
+}
+
+int main() {
+    test_counts();
+    test_json();
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+// ///////////////////////////// MIT License //////////////////////////////////// //
+//                                                                                //
+// Copyright (c) 2013 David Zsolt Manrique                                        //
+//                    david.zsolt.manrique@gmail.com                              //
+//                                                                                //
+// Permission is hereby granted, free of charge, to any person obtaining a copy   //
+// of this software and associated documentation files (the "Software"), to deal  //
+// in the Software without restriction, including without limitation the rights   //
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell      //
+// copies of the Software, and to permit persons to whom the Software is          //
+// furnished to do so, subject to the following conditions:                       //
+//                                                                                //
+// The above copyright notice and this permission notice shall be included in     //
+// all copies or substantial portions of the Software.                            //
+//                                                                                //
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR     //
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,       //
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE    //
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER         //
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,  //
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN      //
+// THE SOFTWARE.                                                                  //
+//                                                                                //
+// ////////////////////////////////////////////////////////////////////////////// //
+
+// manifest validation tool for the job submission options of bench_batch
+// validates every line of a manifest with cmdl::batch and writes the report as tab separated
+// columns: line, code, token, message and one column per option. the exit status is 1 when a
+// line is invalid.
+//
+//   validate_manifest jobs.txt                  report of every line to stdout
+//   validate_manifest jobs.txt -e -j 8          only the invalid lines, on 8 threads
+//   validate_manifest jobs.txt -o report.tsv
+
+#include "cmdl_batch.h"
+
+#include <fstream>
+
+using namespace cmdl;
+
+int main(int argc, char** argv) {
+    arguments args(argc, argv);
+    switcharg<false> help(args, "-h", "--help", "print help message");
+    switcharg<false> errors_only(args, "-e", "--errors", "write the invalid lines only: line, token and message");
+    vararg<unsigned> threads(args, "-j", "--threads", "number of threads, 0 for the hardware concurrency", 0);
+    vararg<std::string> output(args, "-o", "--output", "report file, - for stdout", "-");
+    posarg<std::string> manifest(args, "manifest file, one command line per line", "");
+
+    if (*help || manifest.val().empty()) {
+        args.print_help(std::cout);
+        return *help ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    parser p;
+    p.add<switcharg<false> >("-r", "--retry", "retry failed jobs");
+    p.add<vararg<std::string> >("-q", "--queue", "queue name", "default");
+    p.add<vararg<int> >("-j", "--jobs", "number of jobs", 1);
+    p.add<vararg<long> >("-m", "--memory", "memory in MB", 1024);
+    p.add<vararg<std::string> >("-n", "--name", "job name", "");
+    p.add<multivararg<std::string> >("-e", "--env", "environment variable", "");
+    p.add<tuplevararg<int, int> >("-R", "--range", "first and last task", 0, 0);
+    p.add<multiposarg<std::string> >("input and output files", "", 2);
+
+    try {
+        batch::report report = batch(p).validate_file(*manifest, *threads);
+
+        std::ofstream file;
+        if (*output != "-") file.open(*output, std::ios::binary);
+        std::ostream & os = *output == "-" ? std::cout : file;
+        if (*errors_only) report.print_errors(os);
+        else report.print(os);
+        if (!os.flush()) {
+            std::cerr << "Cannot write " << *output << " report." << std::endl;
+            return EXIT_FAILURE;
+        }
+        return report.errors() ? EXIT_FAILURE : EXIT_SUCCESS;
+    } catch (const std::runtime_error & e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+}